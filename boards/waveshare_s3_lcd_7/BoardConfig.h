@@ -38,6 +38,9 @@
 #define TOUCH_INT 4
 // Touch reset is via CH422G EXIO1
 
+// Gesture thresholds (defaults in device/gesture/GestureRecognizer.h)
+#define GESTURE_SWIPE_MIN_DISTANCE 50
+
 // SD Card pins (SPI)
 // SD CS is via CH422G EXIO4
 #define SD_MOSI 11
@@ -15,7 +15,12 @@
  *====================*/
 
 /* Use standard C library functions instead of LVGL builtins */
+#ifdef ALLOC_TRACKER
+/* src/util/AllocTracker.cpp provides lv_malloc_core & co. */
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM
+#else
 #define LV_USE_STDLIB_MALLOC    LV_STDLIB_CLIB
+#endif
 #define LV_USE_STDLIB_STRING    LV_STDLIB_CLIB
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_CLIB
 
@@ -89,8 +94,8 @@
  * DEVICES
  *==================*/
 
-/*Use SDL to open window on PC (simulator only)*/
-#ifdef BOARD_SIMULATOR
+/*Use SDL to open window on PC (simulator only, not the headless build)*/
+#if defined(BOARD_SIMULATOR) && !defined(SIM_HEADLESS)
     #define LV_USE_SDL              1
     #if LV_USE_SDL
         #define LV_SDL_INCLUDE_PATH     <SDL2/SDL.h>
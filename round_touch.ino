@@ -1,6 +1,8 @@
 #include "src/device/Device.h"
 
 #include "src/application/Application.h"
+#include "src/util/LatencyTracer.h"
+#include "src/util/RenderProfiler.h"
 
 Device device;
 Application app(&device);
@@ -9,9 +11,16 @@ void setup(void) {
   Serial.begin(115200);
   device.init();
   app.init();
+#ifdef RENDER_PROFILER_LOG
+  // per-second FPS / frame-time / flush stats on serial
+  RenderProfiler::setLogging(true);
+#endif
+#ifdef LATENCY_TRACE_LOG
+  // one line per touch: gesture/dispatch/navigate/rebuild/photon times
+  LatencyTracer::setLogging(true);
+#endif
 }
 
 void loop() {
-  // TODO render metrics
   app.loop();
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 import logging
 
 import httpx
-from fastapi import APIRouter, Query
+from fastapi import APIRouter, HTTPException, Query
 
 from app.config import HAConfig
 from app.services.datasources import DataSourceRegistry
@@ -74,6 +74,50 @@ def create_router(datasources: DataSourceRegistry,
         entities.sort(key=lambda e: e["entity_id"])
         return {"count": len(entities), "entities": entities}
 
+    @router.get("/ha/states")
+    async def get_ha_states(
+        ids: str = Query(..., description="Comma-separated entity IDs"),
+        attrs: str | None = Query(None, description="Comma-separated attributes to keep (default: all)"),
+    ):
+        """Current state of several entities in one response, for devices.
+
+        One HA round-trip however many entities a screen shows. Each item has
+        the shape of HA's /api/states/<id> minus timestamps and context;
+        unknown entities are left out. Devices pass the attributes they read
+        in ``attrs`` so forecasts and the like never go over the air.
+        """
+        wanted = {i.strip() for i in ids.split(",") if i.strip()}
+        kept = {a.strip() for a in attrs.split(",") if a.strip()} if attrs else None
+        if not ha_config.url or not ha_config.token:
+            raise HTTPException(503, "Home Assistant not configured")
+
+        try:
+            transport = httpx.AsyncHTTPTransport(local_address="0.0.0.0")
+            async with httpx.AsyncClient(timeout=10.0, transport=transport) as client:
+                resp = await client.get(
+                    f"{ha_config.url.rstrip('/')}/api/states",
+                    headers={"Authorization": f"Bearer {ha_config.token}"},
+                )
+                if resp.status_code != 200:
+                    raise HTTPException(502, f"HA returned HTTP {resp.status_code}")
+                states = resp.json()
+        except httpx.HTTPError as e:
+            logger.error(f"HA batch state error: {e}")
+            raise HTTPException(502, str(e))
+
+        return [
+            {
+                "entity_id": s["entity_id"],
+                "state": s.get("state", "unknown"),
+                "attributes": {
+                    k: v for k, v in s.get("attributes", {}).items()
+                    if kept is None or k in kept
+                },
+            }
+            for s in states
+            if s.get("entity_id") in wanted
+        ]
+
     @router.get("/ha/entity/{entity_id:path}")
     async def get_ha_entity(entity_id: str):
         """Get full details for a specific HA entity, including all attributes."""
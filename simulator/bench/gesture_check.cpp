@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "device/gesture/GestureRecognizer.h"
+#include "platform/SimTouch.h"
+#include "platform/TouchScript.h"
+
+// Gesture check. Replays touch scripts and recordings (the --record /
+// [TouchRec] format, see platform/TouchScript.h) through GestureRecognizer
+// alone, on a virtual millisecond clock, and compares what it recognises
+// with the trace's expectations:
+//
+//   # expect: tap swipe_left long_press
+//   # config: double_tap_ms=300 tap_slop=16
+//
+// "expect" lines add to the expected sequence, in order. Only releases and
+// timeouts are compared (tap, double_tap, long_press, drag_end,
+// swipe_left/right/up/down); drag moves are not. "config" lines, and the
+// same keys given as --<key> N, override GestureConfig, so a board's
+// thresholds can be checked against traces recorded on it. A trace with
+// no expectations just prints what it produced.
+//
+// Exit status 1 if any trace's gestures differ from its expectations.
+
+static GestureRecognizer *s_recognizer = nullptr;
+static uint32_t s_nowMs = 0;
+static int s_x = 0, s_y = 0;
+static bool s_down = false;
+
+// TouchScript drives SimTouch; here it feeds the recognizer under test
+static void feed(bool pressed) {
+  s_recognizer->sample({s_nowMs, s_nowMs * 1000, (int16_t)s_x, (int16_t)s_y,
+                        pressed});
+}
+
+void SimTouch::press(int x, int y) {
+  s_down = true;
+  s_x = x;
+  s_y = y;
+  feed(true);
+}
+
+void SimTouch::move(int x, int y) {
+  if (!s_down) return;
+  s_x = x;
+  s_y = y;
+  feed(true);
+}
+
+void SimTouch::release(int x, int y) {
+  if (!s_down) return;
+  s_down = false;
+  s_x = x;
+  s_y = y;
+  feed(false);
+}
+
+static bool setConfig(GestureConfig &config, const char *key, int value) {
+  if (strcmp(key, "tap_slop") == 0) {
+    config.tapSlop = value;
+  } else if (strcmp(key, "swipe_distance") == 0) {
+    config.swipeMinDistance = value;
+  } else if (strcmp(key, "swipe_velocity") == 0) {
+    config.swipeMinVelocity = value;
+  } else if (strcmp(key, "long_press_ms") == 0) {
+    config.longPressMs = value;
+  } else if (strcmp(key, "double_tap_ms") == 0) {
+    config.doubleTapMs = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static const char *nameOf(const Gesture &g) {
+  switch (g.type) {
+  case GestureType::Tap:
+    return "tap";
+  case GestureType::DoubleTap:
+    return "double_tap";
+  case GestureType::LongPress:
+    return "long_press";
+  case GestureType::DragEnd:
+    return "drag_end";
+  case GestureType::Swipe: {
+    int dx = g.x - g.startX, dy = g.y - g.startY;
+    if (abs(dx) >= abs(dy)) return dx < 0 ? "swipe_left" : "swipe_right";
+    return dy < 0 ? "swipe_up" : "swipe_down";
+  }
+  default:
+    return nullptr; // DragStart / Drag
+  }
+}
+
+static std::string join(const std::vector<std::string> &names) {
+  std::string s;
+  for (const std::string &n : names) s += (s.empty() ? "" : " ") + n;
+  return s.empty() ? "(none)" : s;
+}
+
+// The trace's "# expect:" and "# config:" lines; false if unreadable
+static bool readExpectations(const char *path, std::vector<std::string> &expected,
+                             GestureConfig &config) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  int lineNo = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNo++;
+    char *p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    bool expect = strncmp(p, "# expect:", 9) == 0;
+    bool configure = strncmp(p, "# config:", 9) == 0;
+    if (!expect && !configure) continue;
+    for (char *tok = strtok(p + 9, " \t\r\n"); tok; tok = strtok(nullptr, " \t\r\n")) {
+      if (expect) {
+        expected.push_back(tok);
+        continue;
+      }
+      char *eq = strchr(tok, '=');
+      if (eq) *eq = '\0';
+      if (!eq || !setConfig(config, tok, atoi(eq + 1))) {
+        printf("[GestureCheck] %s:%d: unknown config '%s'\n", path, lineNo, tok);
+      }
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// 0: matched (or nothing expected), 1: mismatch, 2: unreadable
+static int check(const char *path,
+                 const std::vector<std::pair<std::string, int>> &overrides) {
+  GestureConfig config;
+  std::vector<std::string> expected;
+  TouchScript script;
+  if (!readExpectations(path, expected, config) || !script.load(path)) {
+    printf("[GestureCheck] %s: cannot read\n", path);
+    return 2;
+  }
+  // command-line thresholds win over the trace's own
+  for (const auto &o : overrides) setConfig(config, o.first.c_str(), o.second);
+
+  GestureRecognizer recognizer(config);
+  s_recognizer = &recognizer;
+  s_down = false;
+  std::vector<std::string> got;
+  // run on past the last step so pending long presses / taps resolve
+  uint32_t end = script.lastAt() + config.longPressMs + config.doubleTapMs + 100;
+  for (s_nowMs = 0; s_nowMs <= end; s_nowMs++) {
+    script.apply(s_nowMs);
+    recognizer.tick(s_nowMs);
+    Gesture g;
+    while (recognizer.poll(g)) {
+      const char *name = nameOf(g);
+      if (name) got.push_back(name);
+    }
+  }
+  s_recognizer = nullptr;
+
+  if (expected.empty()) {
+    printf("[GestureCheck] %s: %s\n", path, join(got).c_str());
+    return 0;
+  }
+  if (got == expected) {
+    printf("[GestureCheck] %s: ok (%zu gestures)\n", path, got.size());
+    return 0;
+  }
+  printf("[GestureCheck] %s: MISMATCH\n  expected: %s\n  got:      %s\n", path,
+         join(expected).c_str(), join(got).c_str());
+  return 1;
+}
+
+static void usage(const char *argv0) {
+  printf("Usage: %s [--<threshold> N ...] TRACE...\n", argv0);
+  printf("  TRACE               touch script, --record file or [TouchRec] log\n");
+  printf("  --tap_slop N        px (default %d)\n", GESTURE_TAP_SLOP);
+  printf("  --swipe_distance N  px (default %d)\n", GESTURE_SWIPE_MIN_DISTANCE);
+  printf("  --swipe_velocity N  px/s (default %d)\n", GESTURE_SWIPE_MIN_VELOCITY);
+  printf("  --long_press_ms N   0 disables (default %d)\n", GESTURE_LONG_PRESS_MS);
+  printf("  --double_tap_ms N   0 disables (default %d)\n", GESTURE_DOUBLE_TAP_MS);
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::pair<std::string, int>> overrides;
+  std::vector<const char *> traces;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      usage(argv[0]);
+      return 0;
+    }
+    if (strncmp(argv[i], "--", 2) == 0 && i + 1 < argc) {
+      GestureConfig probe;
+      if (!setConfig(probe, argv[i] + 2, 0)) {
+        usage(argv[0]);
+        return 2;
+      }
+      const char *key = argv[i] + 2;
+      overrides.push_back({key, atoi(argv[++i])});
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      traces.push_back(argv[i]);
+    }
+  }
+  if (traces.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  int failed = 0;
+  for (const char *path : traces) {
+    if (check(path, overrides) != 0) failed++;
+  }
+  printf("[GestureCheck] %zu traces, %d failed\n", traces.size(), failed);
+  return failed > 0 ? 1 : 0;
+}
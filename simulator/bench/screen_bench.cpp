@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <ArduinoJson.h>
+
+#include "lvgl.h"
+
+// These includes resolve against our shims due to include path ordering
+#include "device/Device.h"
+#include "application/Application.h"
+#include "config/screens/Routes.h"
+#include "ui/registry/ComponentFactories.h"
+#include "ui/registry/JsonTreeParser.h"
+
+// Screen-build benchmark. For every server/ui/<board>/screens.json and every
+// screen in it, times each stage of getting a user screen onto the display:
+//
+//   load_manifest    UserScreenManager::loadManifest (whole manifest)
+//   build_screen     UserScreenManager::buildScreen (copy + parse + tree)
+//   tree_parse       JsonTreeParser::build on an already-parsed document
+//   create_component createComponentFromState + attachApplication
+//   create_widgets   Component::createWidgets on a fresh screen
+//   first_refr       first full lv_refr_now after lv_screen_load
+//
+// The last three are the steps ComponentManager::createComponent performs,
+// run individually so each can be timed. Times are medians in microseconds.
+
+#ifndef SCREEN_BENCH_UI_DIR
+#define SCREEN_BENCH_UI_DIR "../server/ui"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct ScreenResult {
+  std::string board;
+  int scale = 1;
+  int screen = 0;
+  int nodes = 0;
+  int lvObjects = 0;
+  long heapBytes = 0;
+  double loadManifestUs = 0;
+  double buildScreenUs = 0;
+  double treeParseUs = 0;
+  double createComponentUs = 0;
+  double createWidgetsUs = 0;
+  double firstRefrUs = 0;
+};
+
+static double elapsedUs(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static double median(std::vector<double> v) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[v.size() / 2];
+}
+
+// Bytes currently allocated from the host heap (LVGL uses the C allocator)
+static long heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return (long)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+  return (long)mallinfo().uordblks;
+#else
+  return 0;
+#endif
+}
+
+static int countObjects(lv_obj_t *obj) {
+  int n = 1;
+  uint32_t cnt = lv_obj_get_child_count(obj);
+  for (uint32_t i = 0; i < cnt; i++) n += countObjects(lv_obj_get_child(obj, i));
+  return n;
+}
+
+static int countNodes(JsonObjectConst node) {
+  int n = 1;
+  for (JsonObjectConst child : node["children"].as<JsonArrayConst>()) {
+    n += countNodes(child);
+  }
+  return n;
+}
+
+// Repeat each screen root's children `scale` times to synthesize larger trees
+static std::string scaleManifest(const std::string &json, int scale) {
+  if (scale <= 1) return json;
+  JsonDocument doc;
+  if (deserializeJson(doc, json)) return json;
+  for (JsonPair kv : doc["screens"].as<JsonObject>()) {
+    JsonArray kids = kv.value()["children"];
+    if (!kids) continue;
+    size_t original = kids.size();
+    for (int s = 1; s < scale; s++) {
+      for (size_t i = 0; i < original; i++) kids.add(kids[i]);
+    }
+  }
+  std::string out;
+  serializeJson(doc, out);
+  return out;
+}
+
+static bool readFile(const std::string &path, std::string &out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  out = ss.str();
+  return true;
+}
+
+static void benchManifest(Application &app, const std::string &board,
+                          const std::string &json, int scale, int iterations,
+                          lv_obj_t *blank, std::vector<ScreenResult> &results) {
+  auto &usm = app.userScreenManager();
+  const ComponentRegistry &registry = app.registry();
+
+  JsonDocument manifest;
+  if (deserializeJson(manifest, json)) {
+    printf("[Bench] %s: invalid manifest JSON\n", board.c_str());
+    return;
+  }
+
+  std::vector<double> loadUs;
+  for (int i = 0; i < iterations; i++) {
+    auto t = Clock::now();
+    usm.loadManifest(json.c_str());
+    loadUs.push_back(elapsedUs(t));
+  }
+  double loadMedian = median(loadUs);
+
+  for (JsonPairConst kv : manifest["screens"].as<JsonObjectConst>()) {
+    ScreenResult r;
+    r.board = board;
+    r.scale = scale;
+    r.screen = atoi(kv.key().c_str());
+    r.nodes = countNodes(kv.value().as<JsonObjectConst>());
+    r.loadManifestUs = loadMedian;
+
+    std::string screenJson;
+    serializeJson(kv.value(), screenJson);
+
+    std::vector<double> buildUs, parseUs, componentUs, widgetsUs, refrUs;
+    for (int i = 0; i < iterations; i++) {
+      auto t = Clock::now();
+      Component *built = usm.buildScreen(r.screen, registry);
+      buildUs.push_back(elapsedUs(t));
+      delete built;
+
+      JsonDocument screenDoc;
+      deserializeJson(screenDoc, screenJson);
+      t = Clock::now();
+      Component *parsed = JsonTreeParser::build(screenDoc.as<JsonObject>(), registry);
+      parseUs.push_back(elapsedUs(t));
+      delete parsed;
+
+      long heapBefore = heapInUse();
+
+      t = Clock::now();
+      Component *root = createComponentFromState(r.screen, &app);
+      root->attachApplication(&app);
+      componentUs.push_back(elapsedUs(t));
+
+      lv_obj_t *screen = lv_obj_create(NULL);
+      lv_obj_remove_style_all(screen);
+      t = Clock::now();
+      root->createWidgets(screen);
+      widgetsUs.push_back(elapsedUs(t));
+
+      lv_screen_load(screen);
+      t = Clock::now();
+      lv_refr_now(NULL);
+      refrUs.push_back(elapsedUs(t));
+
+      r.heapBytes = heapInUse() - heapBefore;
+      r.lvObjects = countObjects(screen);
+
+      // tear down so every iteration starts from the same state
+      lv_screen_load(blank);
+      delete root;
+      lv_obj_delete(screen);
+    }
+
+    r.buildScreenUs = median(buildUs);
+    r.treeParseUs = median(parseUs);
+    r.createComponentUs = median(componentUs);
+    r.createWidgetsUs = median(widgetsUs);
+    r.firstRefrUs = median(refrUs);
+    results.push_back(r);
+  }
+}
+
+static void writeCsv(FILE *out, const std::vector<ScreenResult> &results) {
+  fprintf(out, "board,scale,screen,nodes,lv_objects,heap_bytes,load_manifest_us,"
+               "build_screen_us,tree_parse_us,create_component_us,"
+               "create_widgets_us,first_refr_us\n");
+  for (auto &r : results) {
+    fprintf(out, "%s,%d,%d,%d,%d,%ld,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+            r.board.c_str(), r.scale, r.screen, r.nodes, r.lvObjects,
+            r.heapBytes, r.loadManifestUs, r.buildScreenUs, r.treeParseUs,
+            r.createComponentUs, r.createWidgetsUs, r.firstRefrUs);
+  }
+}
+
+static void writeJson(FILE *out, const std::vector<ScreenResult> &results) {
+  JsonDocument doc;
+  doc["screen_width"] = SCREEN_WIDTH;
+  doc["screen_height"] = SCREEN_HEIGHT;
+  JsonArray arr = doc["results"].to<JsonArray>();
+  for (auto &r : results) {
+    JsonObject o = arr.add<JsonObject>();
+    o["board"] = r.board;
+    o["scale"] = r.scale;
+    o["screen"] = r.screen;
+    o["nodes"] = r.nodes;
+    o["lv_objects"] = r.lvObjects;
+    o["heap_bytes"] = r.heapBytes;
+    o["load_manifest_us"] = r.loadManifestUs;
+    o["build_screen_us"] = r.buildScreenUs;
+    o["tree_parse_us"] = r.treeParseUs;
+    o["create_component_us"] = r.createComponentUs;
+    o["create_widgets_us"] = r.createWidgetsUs;
+    o["first_refr_us"] = r.firstRefrUs;
+  }
+  std::string s;
+  serializeJsonPretty(doc, s);
+  fprintf(out, "%s\n", s.c_str());
+}
+
+static void usage(const char *argv0) {
+  printf("Usage: %s [--ui-dir DIR] [--scales 1,10,100] [--iterations N]\n"
+         "          [--format csv|json] [--out FILE]\n", argv0);
+}
+
+int main(int argc, char *argv[]) {
+  std::string uiDir = SCREEN_BENCH_UI_DIR;
+  std::vector<int> scales = {1, 10, 100};
+  int iterations = 5;
+  bool json = false;
+  const char *outPath = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--ui-dir") == 0 && i + 1 < argc) {
+      uiDir = argv[++i];
+    } else if (strcmp(argv[i], "--scales") == 0 && i + 1 < argc) {
+      scales.clear();
+      std::stringstream ss(argv[++i]);
+      std::string item;
+      while (std::getline(ss, item, ',')) scales.push_back(std::max(1, atoi(item.c_str())));
+    } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      json = strcmp(argv[++i], "json") == 0;
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  // collect manifests, sorted so output order is stable between runs
+  std::vector<std::filesystem::path> manifests;
+  std::error_code ec;
+  for (auto &entry : std::filesystem::directory_iterator(uiDir, ec)) {
+    auto path = entry.path() / "screens.json";
+    if (entry.is_directory() && std::filesystem::exists(path)) manifests.push_back(path);
+  }
+  std::sort(manifests.begin(), manifests.end());
+  if (manifests.empty()) {
+    printf("[Bench] No screens.json found under %s\n", uiDir.c_str());
+    return 1;
+  }
+
+  // no app.init(): the benchmark must not depend on a server
+  Device device;
+  Application app(&device);
+  device.init();
+  registerAllComponents(app.registry());
+
+  lv_obj_t *blank = lv_obj_create(NULL);
+  lv_screen_load(blank);
+  lv_refr_now(NULL);
+
+  std::vector<ScreenResult> results;
+  for (auto &path : manifests) {
+    std::string text;
+    if (!readFile(path.string(), text)) continue;
+    std::string board = path.parent_path().filename().string();
+    for (int scale : scales) {
+      benchManifest(app, board, scaleManifest(text, scale), scale, iterations,
+                    blank, results);
+    }
+  }
+
+  FILE *out = outPath ? fopen(outPath, "w") : stdout;
+  if (!out) {
+    printf("[Bench] Cannot open %s\n", outPath);
+    return 1;
+  }
+  if (json) {
+    writeJson(out, results);
+  } else {
+    writeCsv(out, results);
+  }
+  if (out != stdout) fclose(out);
+
+  lv_deinit();
+  return 0;
+}
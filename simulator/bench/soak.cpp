@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <ArduinoJson.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h" // lv_display_t::screens, to count every screen
+
+#include "platform/StubNetwork.h"
+#include "platform/VirtualClock.h"
+#include "util/AllocTracker.h"
+#include "util/WakeSignal.h"
+
+// These includes resolve against our shims due to include path ordering
+#include "device/Device.h"
+#include "application/Application.h"
+#include "application/interface/Toast.h"
+#include "application/interface/components/settings/ContentRefreshPanel.h"
+#include "events/types/TouchEvent.h"
+
+// Soak test. Drives the headless app on the virtual clock through many
+// cycles of:
+//
+//   Workflow::navigate       round-robin over the manifest tabs + the shade
+//   Toast show / dismiss     alternating auto-dismiss and Toast::dismiss()
+//   manifest reload          a tap on a ContentRefreshPanel
+//   ServerText poll ticks    a DynamicText with a short TTL on every screen
+//
+// and samples heap in use, LVGL object / screen / timer counts, the workflow
+// EventQueue size and loop time. Metrics that keep growing after warm-up
+// are flagged and the exit status is 2. A navigate() the workflow drops
+// (e.g. inside its debounce) stops the run with exit status 3, since the
+// cycles after it would not be exercising what they claim to.
+
+#ifndef SOAK_MANIFEST
+#define SOAK_MANIFEST "../server/ui/simulator/screens.json"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+  long cycle = 0;
+  double virtualS = 0;
+  long heapBytes = 0;
+  int lvObjects = 0;
+  int lvScreens = 0;
+  int lvTimers = 0;
+  long workflowQueue = 0;
+  double loopP50Us = 0;
+  double loopP95Us = 0;
+};
+
+static long heapInUse() {
+#ifdef ALLOC_TRACKER
+  return AllocTracker::liveBytes();
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return (long)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+  return (long)mallinfo().uordblks;
+#else
+  return 0;
+#endif
+}
+
+static int countObjects(lv_obj_t *obj) {
+  int n = 1;
+  uint32_t cnt = lv_obj_get_child_count(obj);
+  for (uint32_t i = 0; i < cnt; i++) n += countObjects(lv_obj_get_child(obj, i));
+  return n;
+}
+
+// Every screen the display knows about, including the layers and any
+// screen that was loaded over but never deleted
+static void countLvgl(Sample &s) {
+  lv_display_t *disp = lv_display_get_default();
+  s.lvScreens = (int)disp->screen_cnt;
+  s.lvObjects = 0;
+  for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+    s.lvObjects += countObjects(disp->screens[i]);
+  }
+  s.lvTimers = 0;
+  for (lv_timer_t *t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+    s.lvTimers++;
+  }
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+static bool readFile(const std::string &path, std::string &out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  out = ss.str();
+  return true;
+}
+
+// Append a polling DynamicText to every screen so ServerText ticks run
+static std::string addPollers(const std::string &json, int ttlSeconds) {
+  JsonDocument doc;
+  if (deserializeJson(doc, json)) return json;
+  for (JsonPair kv : doc["screens"].as<JsonObject>()) {
+    JsonArray kids = kv.value()["children"];
+    if (!kids) continue;
+    JsonObject poller = kids.add<JsonObject>();
+    poller["type"] = "DynamicText";
+    poller["content_key"] = std::string("soak_") + kv.key().c_str();
+    poller["props"]["ttl"] = ttlSeconds;
+  }
+  std::string out;
+  serializeJson(doc, out);
+  return out;
+}
+
+// Growth after warm-up that is (almost) never reversed
+static bool growing(const std::vector<double> &v, double minAbs, double minRel) {
+  size_t start = std::max<size_t>(1, v.size() / 10);
+  if (v.size() < start + 4) return false;
+  int rises = 0, steps = 0;
+  for (size_t i = start + 1; i < v.size(); i++) {
+    steps++;
+    if (v[i] >= v[i - 1]) rises++;
+  }
+  double delta = v.back() - v[start];
+  return rises >= steps * 0.8 && delta > minAbs && delta > v[start] * minRel;
+}
+
+static void usage(const char *argv0) {
+  printf("Usage: %s [--cycles N] [--dwell-ms MS] [--sample-every N] [--manifest FILE]\n"
+         "          [--toast-every N] [--reload-every N] [--poll-ttl S] [--out FILE.csv]\n"
+         "          [--mock-* ...]\n", argv0);
+  printf("  --cycles N        navigation cycles (default 100000)\n");
+  printf("  --dwell-ms MS     virtual time spent on each screen, at least the\n"
+         "                    %d ms navigation debounce (default 200)\n",
+         WORKFLOW_DEBOUNCE_MS);
+  printf("  --sample-every N  cycles between samples (default 1000)\n");
+  printf("  --toast-every N   show a toast every N cycles, 0 = off (default 7)\n");
+  printf("  --reload-every N  reload the manifest every N cycles, 0 = off (default 50)\n");
+  printf("  --poll-ttl S      DynamicText poll interval added to each screen, 0 = off\n"
+         "                    (default 1)\n");
+  printf("%s", MockConfig::usage());
+}
+
+int main(int argc, char *argv[]) {
+  long cycles = 100000;
+  int dwellMs = 200;
+  long sampleEvery = 1000;
+  int toastEvery = 7;
+  int reloadEvery = 50;
+  int pollTtl = 1;
+  std::string manifestPath = SOAK_MANIFEST;
+  const char *outPath = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+      cycles = std::max(1L, atol(argv[++i]));
+    } else if (strcmp(argv[i], "--dwell-ms") == 0 && i + 1 < argc) {
+      dwellMs = std::max(WORKFLOW_DEBOUNCE_MS, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--sample-every") == 0 && i + 1 < argc) {
+      sampleEvery = std::max(1L, atol(argv[++i]));
+    } else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc) {
+      manifestPath = argv[++i];
+    } else if (strcmp(argv[i], "--toast-every") == 0 && i + 1 < argc) {
+      toastEvery = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--reload-every") == 0 && i + 1 < argc) {
+      reloadEvery = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--poll-ttl") == 0 && i + 1 < argc) {
+      pollTtl = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (!StubNetwork::config().parseArg(argc, argv, i)) {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::string manifest;
+  if (!readFile(manifestPath, manifest)) {
+    printf("[Soak] Cannot read %s\n", manifestPath.c_str());
+    return 1;
+  }
+  if (pollTtl > 0) manifest = addPollers(manifest, pollTtl);
+  std::string servedPath =
+      (std::filesystem::temp_directory_path() / "round_touch_soak_manifest.json").string();
+  {
+    std::ofstream f(servedPath, std::ios::binary);
+    f << manifest;
+  }
+  StubNetwork::enable(servedPath.c_str());
+
+  Device device;
+  Application app(&device);
+  device.init();
+  app.init();
+
+  std::vector<State> states;
+  for (auto &tab : app.userScreenManager().tabs()) states.push_back(tab.id);
+  states.push_back(SYSTEM_SHADE);
+
+  // Off-screen refresh panel, tapped to reload the manifest the way a user would
+  ContentRefreshPanel refresher;
+  refresher.attachApplication(&app);
+  lv_obj_t *panelRoot = lv_obj_create(NULL);
+  refresher.createWidgets(panelRoot);
+  lv_obj_update_layout(panelRoot);
+  lv_area_t panelArea;
+  lv_obj_get_coords(refresher.lvObj, &panelArea);
+  TouchLocation panelCenter = {(panelArea.x1 + panelArea.x2) / 2,
+                               (panelArea.y1 + panelArea.y2) / 2};
+
+  FILE *out = outPath ? fopen(outPath, "w") : nullptr;
+  if (outPath && !out) {
+    printf("[Soak] Cannot open %s\n", outPath);
+    return 1;
+  }
+  if (out) {
+    fprintf(out, "cycle,virtual_s,heap_bytes,lv_objects,lv_screens,lv_timers,"
+                 "workflow_queue,loop_p50_us,loop_p95_us\n");
+  }
+
+  std::vector<double> loopUs;
+  auto runFor = [&](unsigned long ms) {
+    unsigned long until = VirtualClock::now() + ms;
+    while (VirtualClock::now() < until) {
+      WakeSignal::wakeBy(until);
+      auto t = Clock::now();
+      app.loop();
+      loopUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t).count());
+    }
+  };
+
+  std::vector<Sample> samples;
+  auto sample = [&](long cycle) {
+    Sample s;
+    s.cycle = cycle;
+    s.virtualS = VirtualClock::now() / 1000.0;
+    s.heapBytes = heapInUse();
+    countLvgl(s);
+    s.workflowQueue = (long)app.eventhub().workflowEvents().size();
+    s.loopP50Us = percentile(loopUs, 0.50);
+    s.loopP95Us = percentile(loopUs, 0.95);
+    loopUs.clear();
+    samples.push_back(s);
+    printf("[Soak] cycle=%ld t=%.0fs heap=%ld objs=%d screens=%d timers=%d "
+           "queue=%ld p50=%.0fus p95=%.0fus\n",
+           s.cycle, s.virtualS, s.heapBytes, s.lvObjects, s.lvScreens, s.lvTimers,
+           s.workflowQueue, s.loopP50Us, s.loopP95Us);
+    if (out) {
+      fprintf(out, "%ld,%.1f,%ld,%d,%d,%d,%ld,%.1f,%.1f\n", s.cycle, s.virtualS,
+              s.heapBytes, s.lvObjects, s.lvScreens, s.lvTimers, s.workflowQueue,
+              s.loopP50Us, s.loopP95Us);
+      fflush(out);
+    }
+  };
+
+  printf("[Soak] %ld cycles over %d states, %d ms dwell\n", cycles,
+         (int)states.size(), dwellMs);
+  auto wallStart = Clock::now();
+
+  bool dropped = false;
+  for (long c = 0; c < cycles; c++) {
+    State target = states[c % states.size()];
+    app.workflow().navigate(target);
+    if (app.workflow().getState() != target) {
+      printf("[Soak] cycle %ld: navigate to %d dropped, still on %d\n", c, target,
+             app.workflow().getState());
+      dropped = true;
+      break;
+    }
+
+    bool manualToast = false;
+    if (toastEvery > 0 && c % toastEvery == 0) {
+      manualToast = (c / toastEvery) % 2 == 1;
+      if (manualToast) {
+        Toast::show("Soak", {.label = "OK"});
+      } else {
+        Toast::show("Soak", dwellMs / 2);
+      }
+    }
+
+    runFor(dwellMs / 2);
+    if (manualToast) Toast::dismiss();
+    if (reloadEvery > 0 && c % reloadEvery == reloadEvery - 1) {
+      TapTouchEvent tap(panelCenter);
+      refresher.handleEvent(tap);
+    }
+    runFor(dwellMs - dwellMs / 2);
+
+    if (c % sampleEvery == 0) sample(c);
+  }
+  sample(cycles);
+
+  double wallS = std::chrono::duration<double>(Clock::now() - wallStart).count();
+  printf("[Soak] %ld cycles, %.0f virtual s in %.1f s\n", cycles,
+         VirtualClock::now() / 1000.0, wallS);
+
+  // metric, series, minimum absolute growth, minimum relative growth
+  struct Check {
+    const char *name;
+    std::vector<double> values;
+    double minAbs;
+    double minRel;
+  };
+  std::vector<Check> checks = {
+      {"heap_bytes", {}, 4096, 0.01},  {"lv_objects", {}, 0, 0},
+      {"lv_screens", {}, 0, 0},        {"lv_timers", {}, 0, 0},
+      {"workflow_queue", {}, 0, 0},    {"loop_p95_us", {}, 200, 0.5},
+  };
+  for (const Sample &s : samples) {
+    checks[0].values.push_back(s.heapBytes);
+    checks[1].values.push_back(s.lvObjects);
+    checks[2].values.push_back(s.lvScreens);
+    checks[3].values.push_back(s.lvTimers);
+    checks[4].values.push_back(s.workflowQueue);
+    checks[5].values.push_back(s.loopP95Us);
+  }
+
+  bool anyGrowth = false;
+  for (const Check &check : checks) {
+    bool grows = growing(check.values, check.minAbs, check.minRel);
+    anyGrowth |= grows;
+    printf("[Soak] %-15s %s (%.0f -> %.0f)\n", check.name,
+           grows ? "GROWING" : "flat", check.values.front(), check.values.back());
+  }
+
+  if (out) fclose(out);
+  std::filesystem::remove(servedPath);
+  lv_deinit();
+  if (dropped) return 3;
+  return anyGrowth ? 2 : 0;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "lvgl.h"
+
+#include "platform/StubNetwork.h"
+#include "platform/TouchScript.h"
+#include "platform/VirtualClock.h"
+#include "SimDrivers.h"
+#include "util/AllocTracker.h"
+#include "util/LatencyTracer.h"
+#include "util/RenderProfiler.h"
+#include "util/WakeSignal.h"
+
+// These includes resolve against our shims due to include path ordering
+#include "device/Device.h"
+#include "application/Application.h"
+
+// Headless simulator: runs the application against an in-memory framebuffer
+// on a virtual clock. Each loop iteration advances time by the application's
+// own sleep (LoopScheduler), so runs are repeatable and independent of host
+// speed.
+
+static void usage(const char *argv0) {
+  printf("Usage: %s [--loops N] [--script FILE] [--offline] [--manifest FILE]\n"
+         "          [--dump FILE.ppm] [--profile] [--latency] [--mock-* ...]\n", argv0);
+  printf("  --loops N      loop iterations to run (default 500, or until the\n"
+         "                 script has finished plus one second)\n");
+  printf("  --script FILE  timed touch script or recording to replay\n");
+  printf("  --offline      stubbed network (platform/StubNetwork.h)\n");
+  printf("  --manifest F   serve F as the UI manifest (implies --offline)\n");
+  printf("  --dump FILE    write the final framebuffer as a binary PPM\n");
+  printf("  --profile      log render stats for every virtual second\n");
+  printf("  --latency      log touch-to-photon stages and print the histogram\n");
+  printf("Stubbed network knobs (imply --offline):\n%s", MockConfig::usage());
+}
+
+static bool dumpPPM(const char *path, const uint16_t *fb, int w, int h) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P6\n%d %d\n255\n", w, h);
+  for (int i = 0; i < w * h; i++) {
+    uint16_t c = fb[i];
+    uint8_t rgb[3] = {
+        (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+        (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+        (uint8_t)((c & 0x1F) * 255 / 31),
+    };
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  int loops = 0;
+  const char *scriptPath = nullptr;
+  const char *dumpPath = nullptr;
+  const char *manifestPath = nullptr;
+  bool offline = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+      loops = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+      scriptPath = argv[++i];
+    } else if (strcmp(argv[i], "--offline") == 0) {
+      offline = true;
+    } else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc) {
+      manifestPath = argv[++i];
+    } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+      dumpPath = argv[++i];
+    } else if (strcmp(argv[i], "--profile") == 0) {
+      RenderProfiler::setLogging(true);
+    } else if (strcmp(argv[i], "--latency") == 0) {
+      LatencyTracer::setLogging(true);
+    } else if (StubNetwork::config().parseArg(argc, argv, i)) {
+      offline = true;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  TouchScript script;
+  if (scriptPath && !script.load(scriptPath)) return 1;
+  if (offline || manifestPath) StubNetwork::enable(manifestPath);
+
+  Device device;
+  Application app(&device);
+
+  device.init();
+  app.init();
+
+  // with a script and no explicit count, run until it has played out
+  unsigned long settleUntil = script.size() > 0 ? script.lastAt() + 1000 : 0;
+  if (loops == 0 && script.size() == 0) loops = 500;
+  auto keepRunning = [&](int i) {
+    if (loops > 0) return i < loops;
+    return !script.done() || VirtualClock::now() < settleUntil;
+  };
+
+  printf("Headless simulator running at %dx%d.\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> loopUs;
+
+  auto runStart = Clock::now();
+  int i = 0;
+  for (; keepRunning(i); i++) {
+    script.apply(VirtualClock::now());
+    if (!script.done()) WakeSignal::wakeBy(script.nextAt());
+
+    auto t0 = Clock::now();
+    app.loop();
+    auto t1 = Clock::now();
+    loopUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+  double wallMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+  auto &display = static_cast<MemoryDisplayDriver &>(device.display());
+
+  // summary: wall-clock cost per loop against virtual time covered
+  std::vector<double> sorted = loopUs;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (double us : loopUs) sum += us;
+  auto pct = [&](double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = (size_t)(p * (sorted.size() - 1));
+    return sorted[idx];
+  };
+
+  printf("loops=%d virtual_ms=%lu wall_ms=%.1f flushes=%u\n", i,
+         VirtualClock::now(), wallMs, display.flushCount());
+  printf("loop_us avg=%.1f p50=%.1f p95=%.1f max=%.1f\n",
+         loopUs.empty() ? 0.0 : sum / loopUs.size(), pct(0.50), pct(0.95),
+         sorted.empty() ? 0.0 : sorted.back());
+
+  if (LatencyTracer::histogram(LatencyStage::Dispatch).count > 0) {
+    LatencyTracer::dump();
+  }
+#ifdef ALLOC_TRACKER
+  AllocTracker::report();
+#endif
+
+  if (dumpPath) {
+    if (dumpPPM(dumpPath, display.framebuffer(), SCREEN_WIDTH, SCREEN_HEIGHT)) {
+      printf("Framebuffer written to %s\n", dumpPath);
+    } else {
+      printf("Failed to write %s\n", dumpPath);
+    }
+  }
+
+  lv_deinit();
+  return 0;
+}
@@ -1,24 +1,52 @@
 #include <SDL2/SDL.h>
 #include <cstdio>
+#include <cstring>
 
 #include "lvgl.h"
 
 #include "platform/SimTouch.h"
+#include "platform/StubNetwork.h"
+#include "platform/TouchScript.h"
+#include "util/AllocTracker.h"
+#include "util/LatencyTracer.h"
+#include "util/RenderProfiler.h"
+#include "util/TouchRecorder.h"
+#include "util/WakeSignal.h"
 
 // These includes resolve against our shims due to include path ordering
 #include "device/Device.h"
 #include "application/Application.h"
 
-int main(int, char *[]) {
+int main(int argc, char *argv[]) {
+  TouchScript replay;
+  bool offline = false;
+  const char *manifestPath = nullptr;
+  for (int i = 1; i < argc; i++) {
+    // --profile: per-second render stats on stdout
+    if (strcmp(argv[i], "--profile") == 0) RenderProfiler::setLogging(true);
+    // --latency: per-touch stage timings, histogram on exit
+    if (strcmp(argv[i], "--latency") == 0) LatencyTracer::setLogging(true);
+    // --record FILE: write touch input as a replayable script
+    if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) TouchRecorder::open(argv[++i]);
+    // --replay FILE: feed a recorded/authored touch script
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      if (!replay.load(argv[++i])) return 1;
+    }
+    // --offline / --manifest FILE: stubbed network, optional fixed manifest
+    else if (strcmp(argv[i], "--offline") == 0) offline = true;
+    else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc) manifestPath = argv[++i];
+    // --mock-latency MS etc.: stubbed network with injected latency/errors
+    else if (StubNetwork::config().parseArg(argc, argv, i)) offline = true;
+  }
+  if (offline || manifestPath) StubNetwork::enable(manifestPath);
+
   // Initialize application (Device::init handles lv_init + LVGL display)
   Device device;
   Application app(&device);
 
+  // the touchscreen (fed by SDL mouse via SimTouch) is registered as the
+  // LVGL pointer by Device::init
   device.init();
-
-  // Create LVGL SDL mouse input device (after lv_init in device.init)
-  lv_sdl_mouse_create();
-
   app.init();
 
   printf("Simulator running. Click to tap, click+drag to swipe.\n");
@@ -36,12 +64,17 @@ int main(int, char *[]) {
       SimTouch::processEvent(event);
     }
 
+    replay.apply(millis());
+    // the app sleeps between passes; don't let it sleep past a replay step
+    if (!replay.done()) WakeSignal::wakeBy(replay.nextAt());
     app.loop();
-
-    // Small delay to prevent CPU spinning
-    SDL_Delay(5);
   }
 
+  LatencyTracer::dump();
+#ifdef ALLOC_TRACKER
+  AllocTracker::report();
+#endif
+  TouchRecorder::close();
   lv_deinit();
   return 0;
 }
@@ -0,0 +1,375 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "device/network/WebSocketKey.h"
+#include "platform/MockRoutes.h"
+
+// Stand-alone HTTP/1.1 stand-in for Home Assistant and the control server,
+// serving MockRoutes over a socket. Point HA_BASE_URL and OTA_UPDATE_URL in
+// NetworkConfig.h at it to run the SDL simulator (or a device on the LAN)
+// against controlled latency, errors and payload sizes.
+//
+// One thread per connection; keep-alive is honoured. GET /api/websocket
+// with Upgrade: websocket speaks enough of HA's WebSocket API for
+// HAWebSocket: auth (any token), subscribe_entities, unsubscribe_events
+// and ping. States changed by service calls, from this client or any
+// other, are pushed to subscribers as "c" diffs.
+
+static void usage(const char *argv0) {
+  printf("Usage: %s [--port N] [--manifest FILE] [--mock-* ...]\n", argv0);
+  printf("  --port N       listen port (default 8123)\n");
+  printf("  --manifest F   serve F as /api/ui/screens\n");
+  printf("  --quiet        don't log requests\n");
+  printf("%s", MockConfig::usage());
+}
+
+static bool s_quiet = false;
+
+static bool sendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    sent += n;
+  }
+  return true;
+}
+
+static const char *reason(int status) {
+  switch (status) {
+  case 200: return "OK";
+  case 304: return "Not Modified";
+  case 400: return "Bad Request";
+  case 404: return "Not Found";
+  default: return "Internal Server Error";
+  }
+}
+
+// Case-insensitive header lookup in the raw header block
+static std::string header(const std::string &head, const char *name) {
+  size_t len = strlen(name);
+  size_t pos = head.find("\r\n");
+  while (pos != std::string::npos && pos + 2 < head.size()) {
+    size_t start = pos + 2;
+    size_t end = head.find("\r\n", start);
+    if (end == std::string::npos) end = head.size();
+    if (end - start > len && head[start + len] == ':' &&
+        strncasecmp(head.c_str() + start, name, len) == 0) {
+      size_t v = start + len + 1;
+      while (v < end && head[v] == ' ') v++;
+      return head.substr(v, end - v);
+    }
+    pos = end;
+  }
+  return "";
+}
+
+// One unmasked server frame (RFC 6455 5.2)
+static bool sendFrame(int fd, uint8_t opcode, const std::string &payload) {
+  std::string frame(1, (char)(0x80 | opcode));
+  size_t len = payload.size();
+  if (len < 126) {
+    frame += (char)len;
+  } else if (len <= 0xFFFF) {
+    frame += (char)126;
+    frame += (char)(len >> 8);
+    frame += (char)len;
+  } else {
+    frame += (char)127;
+    for (int i = 7; i >= 0; i--) frame += (char)((uint64_t)len >> (i * 8));
+  }
+  return sendAll(fd, frame + payload);
+}
+
+static bool sendJson(int fd, const JsonDocument &doc) {
+  std::string text;
+  serializeJson(doc, text);
+  if (!s_quiet) printf("[MockServer] ws <- %s\n", text.c_str());
+  return sendFrame(fd, 0x1, text);
+}
+
+// Next client frame out of buf, reading more within timeoutMs. 1: got one,
+// 0: timed out, -1: connection gone.
+static int readFrame(int fd, std::string &buf, int timeoutMs, uint8_t &opcode,
+                     std::string &payload) {
+  for (;;) {
+    if (buf.size() >= 2) {
+      uint64_t len = (uint8_t)buf[1] & 0x7F;
+      size_t headerLen = 2 + ((uint8_t)buf[1] & 0x80 ? 4 : 0);
+      if (len == 126) headerLen += 2;
+      else if (len == 127) headerLen += 8;
+      if (buf.size() >= headerLen) {
+        if (len == 126) {
+          len = ((uint8_t)buf[2] << 8) | (uint8_t)buf[3];
+        } else if (len == 127) {
+          len = 0;
+          for (int i = 0; i < 8; i++) len = (len << 8) | (uint8_t)buf[2 + i];
+        }
+        if (buf.size() >= headerLen + len) {
+          opcode = buf[0] & 0x0F;
+          payload = buf.substr(headerLen, len);
+          if ((uint8_t)buf[1] & 0x80) {
+            const char *mask = buf.data() + headerLen - 4;
+            for (size_t i = 0; i < payload.size(); i++) payload[i] ^= mask[i % 4];
+          }
+          buf.erase(0, headerLen + len);
+          return 1;
+        }
+      }
+    }
+    pollfd pfd = {fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready == 0) return 0;
+    char chunk[4096];
+    ssize_t n = ready > 0 ? recv(fd, chunk, sizeof(chunk), 0) : -1;
+    if (n <= 0) return -1;
+    buf.append(chunk, n);
+  }
+}
+
+// Compressed state, as subscribe_entities sends it: {"s", "a"}
+static void compressedState(MockRoutes *routes, const std::string &entityId,
+                            JsonObject out) {
+  out["s"] = routes->entityState(entityId);
+  routes->entityAttributes(entityId, out["a"].to<JsonObject>());
+}
+
+static void serveWebSocket(int fd, const std::string &head, std::string buf,
+                           MockRoutes *routes) {
+  std::string key = header(head, "Sec-WebSocket-Key");
+  std::string out = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                    "Connection: Upgrade\r\nSec-WebSocket-Accept: " +
+                    webSocketAcceptKey(key.c_str()) + "\r\n\r\n";
+  if (!sendAll(fd, out)) return;
+  if (!s_quiet) printf("[MockServer] websocket open\n");
+
+  JsonDocument hello;
+  hello["type"] = "auth_required";
+  hello["ha_version"] = "mock";
+  if (!sendJson(fd, hello)) return;
+
+  bool authed = false;
+  unsigned subscription = 0;
+  std::map<std::string, std::string> sent; // entity -> state last pushed
+  unsigned version = routes->stateVersion();
+  for (;;) {
+    // push whatever service calls changed since the last look
+    unsigned now = routes->stateVersion();
+    if (subscription != 0 && now != version) {
+      JsonDocument event;
+      event["id"] = subscription;
+      event["type"] = "event";
+      JsonObject changes = event["event"]["c"].to<JsonObject>();
+      for (auto &kv : sent) {
+        std::string state = routes->entityState(kv.first);
+        if (state == kv.second) continue;
+        kv.second = state;
+        changes[kv.first]["+"]["s"] = state;
+      }
+      if (changes.size() > 0 && !sendJson(fd, event)) return;
+    }
+    version = now;
+
+    uint8_t opcode;
+    std::string payload;
+    int got = readFrame(fd, buf, 100, opcode, payload);
+    if (got < 0) return;
+    if (got == 0) continue;
+    if (opcode == 0x8) { // close: echo it
+      sendFrame(fd, 0x8, payload.substr(0, 2));
+      return;
+    }
+    if (opcode == 0x9) {
+      if (!sendFrame(fd, 0xA, payload)) return;
+      continue;
+    }
+    if (opcode != 0x1) continue;
+    if (!s_quiet) printf("[MockServer] ws -> %s\n", payload.c_str());
+
+    JsonDocument msg;
+    if (deserializeJson(msg, payload)) return;
+    std::string type = msg["type"] | "";
+    JsonDocument reply;
+    if (!authed) {
+      bool ok = type == "auth" && !(msg["access_token"] | std::string()).empty();
+      reply["type"] = ok ? "auth_ok" : "auth_invalid";
+      if (!ok) reply["message"] = "Invalid access token or password";
+      if (!sendJson(fd, reply) || !ok) return;
+      authed = true;
+      continue;
+    }
+
+    unsigned id = msg["id"] | 0u;
+    reply["id"] = id;
+    if (type == "ping") {
+      reply["type"] = "pong";
+      if (!sendJson(fd, reply)) return;
+      continue;
+    }
+    reply["type"] = "result";
+    if (type == "subscribe_entities") {
+      subscription = id;
+      sent.clear();
+      reply["success"] = true;
+      reply["result"] = nullptr;
+      if (!sendJson(fd, reply)) return;
+      JsonDocument event;
+      event["id"] = id;
+      event["type"] = "event";
+      JsonObject added = event["event"]["a"].to<JsonObject>();
+      for (JsonVariantConst entity : msg["entity_ids"].as<JsonArrayConst>()) {
+        std::string entityId = entity | "";
+        compressedState(routes, entityId, added[entityId].to<JsonObject>());
+        sent[entityId] = added[entityId]["s"].as<std::string>();
+      }
+      if (!sendJson(fd, event)) return;
+    } else if (type == "unsubscribe_events") {
+      if ((msg["subscription"] | 0u) == subscription) subscription = 0;
+      reply["success"] = true;
+      reply["result"] = nullptr;
+      if (!sendJson(fd, reply)) return;
+    } else {
+      reply["success"] = false;
+      reply["error"]["code"] = "unknown_command";
+      reply["error"]["message"] = "Unknown command.";
+      if (!sendJson(fd, reply)) return;
+    }
+  }
+}
+
+static void serve(int fd, MockRoutes *routes) {
+  std::string buf;
+  char chunk[4096];
+  bool keepAlive = true;
+
+  while (keepAlive) {
+    size_t headEnd;
+    while ((headEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+      ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+      if (n <= 0) {
+        close(fd);
+        return;
+      }
+      buf.append(chunk, n);
+    }
+    std::string head = buf.substr(0, headEnd);
+    size_t contentLength = strtoul(header(head, "Content-Length").c_str(), nullptr, 10);
+    while (buf.size() < headEnd + 4 + contentLength) {
+      ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+      if (n <= 0) {
+        close(fd);
+        return;
+      }
+      buf.append(chunk, n);
+    }
+    std::string body = buf.substr(headEnd + 4, contentLength);
+    buf.erase(0, headEnd + 4 + contentLength);
+
+    // "GET /api/states/x HTTP/1.1"
+    std::string line = head.substr(0, head.find("\r\n"));
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.find(' ', sp1 + 1);
+    std::string method = line.substr(0, sp1);
+    std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string version = sp2 == std::string::npos ? "" : line.substr(sp2 + 1);
+
+    if (target == "/api/websocket" &&
+        strcasecmp(header(head, "Upgrade").c_str(), "websocket") == 0) {
+      serveWebSocket(fd, head, buf, routes);
+      break;
+    }
+
+    std::string connection = header(head, "Connection");
+    keepAlive = version == "HTTP/1.1" ? strcasecmp(connection.c_str(), "close") != 0
+                                      : strcasecmp(connection.c_str(), "keep-alive") == 0;
+
+    std::string ifNoneMatch = header(head, "If-None-Match");
+    MockResponse resp = routes->handle(method.c_str(), target.c_str(), body.c_str(),
+                                       ifNoneMatch.empty() ? nullptr : ifNoneMatch.c_str());
+    int delayMs = routes->sampleDelayMs();
+    if (delayMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+
+    if (!s_quiet) {
+      printf("[MockServer] %s %s -> %d (%zu B, %d ms)\n", method.c_str(), target.c_str(),
+             resp.status, resp.body.size(), delayMs);
+    }
+
+    char statusLine[160];
+    snprintf(statusLine, sizeof(statusLine),
+             "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+             "Content-Length: %zu\r\nConnection: %s\r\n",
+             resp.status, reason(resp.status), resp.body.size(),
+             keepAlive ? "keep-alive" : "close");
+    std::string out = statusLine;
+    if (!resp.etag.empty()) out += "ETag: \"" + resp.etag + "\"\r\n";
+    out += "\r\n";
+    out += resp.body;
+    if (!sendAll(fd, out)) break;
+  }
+  close(fd);
+}
+
+int main(int argc, char *argv[]) {
+  int port = 8123;
+  MockConfig config;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc) {
+      config.manifestPath = argv[++i];
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      s_quiet = true;
+    } else if (!config.parseArg(argc, argv, i)) {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenFd < 0) {
+    perror("socket");
+    return 1;
+  }
+  int one = 1;
+  setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+    perror("bind/listen");
+    return 1;
+  }
+
+  MockRoutes routes(config);
+  printf("[MockServer] Listening on :%d (latency %d±%d ms, errors %.0f%%, "
+         "payload +%d B, entities %d)\n",
+         port, config.latencyMs, config.jitterMs, config.errorRate * 100.0f,
+         config.payloadBytes, config.entityCount);
+
+  while (true) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) continue;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::thread(serve, fd, &routes).detach();
+  }
+}
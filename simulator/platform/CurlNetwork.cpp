@@ -1,14 +1,12 @@
 #include "platform/CurlNetwork.h"
 
-#include <curl/curl.h>
+#include <algorithm>
 #include <cstdio>
 #include <string>
+#include <vector>
 
-static size_t writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata) {
-  std::string *response = static_cast<std::string *>(userdata);
-  response->append(ptr, size * nmemb);
-  return size * nmemb;
-}
+#include "platform/PosixSocket.h"
+#include "util/AllocTracker.h"
 
 static size_t headerCallback(char *buffer, size_t size, size_t nitems, void *userdata) {
   std::string *etag = static_cast<std::string *>(userdata);
@@ -26,98 +24,228 @@ static size_t headerCallback(char *buffer, size_t size, size_t nitems, void *use
   return size * nitems;
 }
 
-void CurlNetwork::init() {
-  curl_global_init(CURL_GLOBAL_DEFAULT);
-  printf("[CurlNetwork] Initialized (desktop HTTP via libcurl)\n");
-}
+// One easy handle's state, from admission to completion
+struct Transfer {
+  PendingRequest pending;
+  CURL *curl = nullptr;
+  curl_slist *headers = nullptr;
+  ResponseBuffer body;
+  bool tooLarge = false;
+  std::string etag;
+};
 
-bool CurlNetwork::isConnected() {
-  return true;
+static size_t writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  Transfer *t = static_cast<Transfer *>(userdata);
+  if (t->body.empty()) {
+    // size the block once from Content-Length, when the server sent one
+    curl_off_t length = -1;
+    curl_easy_getinfo(t->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+    if (length > RESPONSE_BUFFER_MAX) {
+      t->tooLarge = true;
+      return 0;
+    }
+    if (length > 0) t->body.reserve((size_t)length);
+  }
+  if (!t->body.append(ptr, size * nmemb)) {
+    t->tooLarge = true;
+    return 0; // curl aborts with CURLE_WRITE_ERROR
+  }
+  return size * nmemb;
 }
 
-HttpResponse CurlNetwork::get(const char *url, const char *authHeader,
-                               const char *ifNoneMatch) {
-  HttpResponse response;
-  CURL *curl = curl_easy_init();
-  if (!curl) return response;
-
-  std::string responseBody;
-  std::string etagValue;
-  struct curl_slist *headers = nullptr;
-  if (authHeader) {
-    std::string hdr = std::string("Authorization: ") + authHeader;
-    headers = curl_slist_append(headers, hdr.c_str());
+static Transfer *startTransfer(PendingRequest &pending, CURL *curl,
+                               unsigned long now) {
+  Transfer *t = new Transfer();
+  t->pending = std::move(pending);
+  const HttpRequest &req = t->pending.req;
+  t->curl = curl;
+
+  if (req.authHeader.length() > 0) {
+    std::string hdr = std::string("Authorization: ") + req.authHeader.c_str();
+    t->headers = curl_slist_append(t->headers, hdr.c_str());
   }
-  if (ifNoneMatch) {
-    std::string hdr = std::string("If-None-Match: ") + ifNoneMatch;
-    headers = curl_slist_append(headers, hdr.c_str());
+  if (req.method == HttpRequest::Method::Post) {
+    std::string hdr = std::string("Content-Type: ") + req.contentType.c_str();
+    t->headers = curl_slist_append(t->headers, hdr.c_str());
+    // COPYPOSTFIELDS: the request string isn't kept alive for curl
+    curl_easy_setopt(t->curl, CURLOPT_COPYPOSTFIELDS, req.body.c_str());
+  } else if (req.ifNoneMatch.length() > 0) {
+    std::string hdr = std::string("If-None-Match: ") + req.ifNoneMatch.c_str();
+    t->headers = curl_slist_append(t->headers, hdr.c_str());
   }
 
-  curl_easy_setopt(curl, CURLOPT_URL, url);
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBody);
-  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
-  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &etagValue);
-  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-  if (headers) {
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(t->curl, CURLOPT_URL, req.url.c_str());
+  curl_easy_setopt(t->curl, CURLOPT_WRITEFUNCTION, writeCallback);
+  curl_easy_setopt(t->curl, CURLOPT_WRITEDATA, t);
+  curl_easy_setopt(t->curl, CURLOPT_HEADERFUNCTION, headerCallback);
+  curl_easy_setopt(t->curl, CURLOPT_HEADERDATA, &t->etag);
+  curl_easy_setopt(t->curl, CURLOPT_TIMEOUT_MS,
+                   (long)t->pending.remaining(now, CURL_NETWORK_DEFAULT_TIMEOUT_MS));
+  curl_easy_setopt(t->curl, CURLOPT_MAXAGE_CONN, (long)CURL_NETWORK_IDLE_TIMEOUT_S);
+  curl_easy_setopt(t->curl, CURLOPT_PRIVATE, t);
+  if (t->headers) {
+    curl_easy_setopt(t->curl, CURLOPT_HTTPHEADER, t->headers);
   }
+  return t;
+}
 
-  CURLcode res = curl_easy_perform(curl);
+static void finishTransfer(Transfer *t, CURLcode res) {
+  AllocScope scope(AllocPhase::Network);
+  HttpResponse response;
   if (res == CURLE_OK) {
     long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    curl_easy_getinfo(t->curl, CURLINFO_RESPONSE_CODE, &httpCode);
     response.statusCode = (int)httpCode;
     if (httpCode != 304) {
-      response.body = String(responseBody.c_str());
+      response.body = std::move(t->body);
     }
-    if (!etagValue.empty()) {
-      response.etag = String(etagValue.c_str());
+    if (!t->etag.empty()) {
+      response.etag = String(t->etag.c_str());
     }
+    // curl pushes the body at us: buffer it, then run onBody over it
+    INetwork::streamBuffered(t->pending.req, response);
+  } else if (res == CURLE_WRITE_ERROR && t->tooLarge) {
+    printf("[CurlNetwork] %s: body over %u bytes, dropped\n",
+           t->pending.req.url.c_str(), (unsigned)RESPONSE_BUFFER_MAX);
+    response.statusCode = HTTP_ERROR_TOO_LARGE;
+  } else if (res == CURLE_OPERATION_TIMEDOUT && t->pending.req.timeoutMs > 0) {
+    response.statusCode = HTTP_ERROR_DEADLINE;
   } else {
-    printf("[CurlNetwork] GET failed: %s\n", curl_easy_strerror(res));
+    printf("[CurlNetwork] %s %s failed: %s\n",
+           t->pending.req.method == HttpRequest::Method::Post ? "POST" : "GET",
+           t->pending.req.url.c_str(), curl_easy_strerror(res));
   }
+  t->pending.onDone(response);
+}
 
-  curl_slist_free_all(headers);
-  curl_easy_cleanup(curl);
-  return response;
+// Returns the easy handle, reset for the next transfer. Its connection
+// stays in the multi handle's cache for the next request to that host.
+static CURL *freeTransfer(CURLM *multi, Transfer *t) {
+  CURL *curl = t->curl;
+  curl_multi_remove_handle(multi, curl);
+  curl_slist_free_all(t->headers);
+  delete t;
+  curl_easy_reset(curl);
+  return curl;
 }
 
-HttpResponse CurlNetwork::post(const char *url, const char *body,
-                                const char *contentType,
-                                const char *authHeader) {
-  HttpResponse response;
-  CURL *curl = curl_easy_init();
-  if (!curl) return response;
+void CurlNetwork::init() {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  _multi = curl_multi_init();
+  curl_multi_setopt(_multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                    (long)CURL_NETWORK_MAX_HOST_CONNECTIONS);
+  curl_multi_setopt(_multi, CURLMOPT_MAXCONNECTS,
+                    (long)CURL_NETWORK_MAX_CONNECTIONS);
+  _thread = std::thread(&CurlNetwork::run, this);
+  printf("[CurlNetwork] Initialized (desktop HTTP via libcurl multi, %d concurrent)\n",
+         CURL_NETWORK_MAX_ACTIVE);
+}
 
-  std::string responseBody;
-  struct curl_slist *headers = nullptr;
+CurlNetwork::~CurlNetwork() {
+  if (!_thread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  curl_multi_wakeup(_multi);
+  _thread.join();
+  curl_multi_cleanup(_multi);
+}
+
+bool CurlNetwork::isConnected() {
+  return true;
+}
 
-  std::string ctHdr = std::string("Content-Type: ") + contentType;
-  headers = curl_slist_append(headers, ctHdr.c_str());
-  if (authHeader) {
-    std::string authHdr = std::string("Authorization: ") + authHeader;
-    headers = curl_slist_append(headers, authHdr.c_str());
+std::unique_ptr<ISocket> CurlNetwork::createSocket() {
+#ifdef SIM_HEADLESS
+  // a long-lived socket thread timing out on the virtual clock would never
+  // see time pass; headless runs stay on REST reads
+  return nullptr;
+#else
+  return std::unique_ptr<ISocket>(new PosixSocket());
+#endif
+}
+
+void CurlNetwork::request(HttpRequest req, HttpCallback onDone) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_stopping && _multi != nullptr) {
+      _queue.push(std::move(req), std::move(onDone));
+      onDone = nullptr;
+    }
   }
+  if (onDone) {
+    HttpResponse failed;
+    onDone(failed);
+    return;
+  }
+  curl_multi_wakeup(_multi);
+}
 
-  curl_easy_setopt(curl, CURLOPT_URL, url);
-  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
-  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBody);
-  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+void CurlNetwork::run() {
+  std::vector<Transfer *> active;
+  std::vector<CURL *> idle; // easy handles kept for reuse
+  for (;;) {
+    // admit queued requests, highest priority first, while there is room
+    std::vector<PendingRequest> admitted, expired;
+    bool stopping;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      stopping = _stopping;
+      PendingRequest pending;
+      unsigned long now = millis();
+      while ((stopping || active.size() + admitted.size() < CURL_NETWORK_MAX_ACTIVE) &&
+             _queue.pop(pending)) {
+        if (stopping || pending.expired(now)) {
+          expired.push_back(std::move(pending));
+        } else {
+          admitted.push_back(std::move(pending));
+        }
+      }
+    }
+    for (PendingRequest &pending : expired) {
+      HttpResponse response;
+      if (!stopping) response.statusCode = HTTP_ERROR_DEADLINE;
+      pending.onDone(response);
+    }
+    unsigned long now = millis();
+    for (PendingRequest &pending : admitted) {
+      CURL *curl;
+      if (idle.empty()) {
+        curl = curl_easy_init();
+      } else {
+        curl = idle.back();
+        idle.pop_back();
+      }
+      Transfer *t = startTransfer(pending, curl, now);
+      curl_multi_add_handle(_multi, t->curl);
+      active.push_back(t);
+    }
 
-  CURLcode res = curl_easy_perform(curl);
-  if (res == CURLE_OK) {
-    long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    response.statusCode = (int)httpCode;
-    response.body = String(responseBody.c_str());
-  } else {
-    printf("[CurlNetwork] POST failed: %s\n", curl_easy_strerror(res));
+    int running = 0;
+    curl_multi_perform(_multi, &running);
+    CURLMsg *msg;
+    int left;
+    while ((msg = curl_multi_info_read(_multi, &left)) != nullptr) {
+      if (msg->msg != CURLMSG_DONE) continue;
+      Transfer *t = nullptr;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&t);
+      CURLcode res = msg->data.result;
+      finishTransfer(t, res);
+      active.erase(std::find(active.begin(), active.end(), t));
+      idle.push_back(freeTransfer(_multi, t));
+    }
+
+    if (stopping) break;
+    // sleeps until a socket is ready, a timeout is due or request() wakes us
+    curl_multi_poll(_multi, nullptr, 0, 1000, nullptr);
   }
 
-  curl_slist_free_all(headers);
-  curl_easy_cleanup(curl);
-  return response;
+  // abandon transfers still running, but answer them
+  for (Transfer *t : active) {
+    HttpResponse failed;
+    t->pending.onDone(failed);
+    curl_easy_cleanup(freeTransfer(_multi, t));
+  }
+  for (CURL *curl : idle) curl_easy_cleanup(curl);
 }
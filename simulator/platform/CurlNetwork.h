@@ -1,18 +1,56 @@
 #ifndef _CURL_NETWORK_H_
 #define _CURL_NETWORK_H_
 
+#include <curl/curl.h>
+#include <mutex>
+#include <thread>
+
 #include "device/INetwork.h"
+#include "device/network/RequestQueue.h"
+
+// Transfers in flight at once; the rest wait in the priority queue
+#ifndef CURL_NETWORK_MAX_ACTIVE
+#define CURL_NETWORK_MAX_ACTIVE 4
+#endif
+// Whole-transfer timeout for requests without a deadline
+#define CURL_NETWORK_DEFAULT_TIMEOUT_MS 10000
+// Keep-alive pool: sockets per host, cached sockets overall, and how long
+// an idle one may be reused (under uvicorn's 5 s keep-alive)
+#ifndef CURL_NETWORK_MAX_HOST_CONNECTIONS
+#define CURL_NETWORK_MAX_HOST_CONNECTIONS 2
+#endif
+#ifndef CURL_NETWORK_MAX_CONNECTIONS
+#define CURL_NETWORK_MAX_CONNECTIONS 4
+#endif
+#define CURL_NETWORK_IDLE_TIMEOUT_S 4
 
+// Desktop HTTP through one curl multi handle, driven by a single network
+// thread: requests queue by priority and up to CURL_NETWORK_MAX_ACTIVE
+// transfers run concurrently. Deadlines become CURLOPT_TIMEOUT_MS, counted
+// from when the request was queued.
+//
+// Finished transfers leave their socket in the multi handle's connection
+// cache, so requests to a host reuse warm keep-alive connections (at most
+// CURL_NETWORK_MAX_HOST_CONNECTIONS each; extra transfers wait inside
+// curl). Easy handles are recycled too. curl reconnects by itself when a
+// cached socket turns out to have been closed.
 class CurlNetwork : public INetwork {
 public:
+  ~CurlNetwork() override;
+
   void init() override;
   bool isConnected() override;
-  HttpResponse get(const char *url,
-                   const char *authHeader = nullptr,
-                   const char *ifNoneMatch = nullptr) override;
-  HttpResponse post(const char *url, const char *body,
-                    const char *contentType = "application/json",
-                    const char *authHeader = nullptr) override;
+  void request(HttpRequest req, HttpCallback onDone) override;
+  std::unique_ptr<ISocket> createSocket() override;
+
+private:
+  std::mutex _mutex;
+  RequestQueue _queue;
+  bool _stopping = false;
+  CURLM *_multi = nullptr;
+  std::thread _thread;
+
+  void run();
 };
 
 #endif // _CURL_NETWORK_H_
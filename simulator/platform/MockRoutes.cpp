@@ -0,0 +1,294 @@
+#include "platform/MockRoutes.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <ArduinoJson.h>
+
+#include "config/Version.h"
+
+bool MockConfig::parseArg(int argc, char *argv[], int &i) {
+  const char *arg = argv[i];
+  if (i + 1 >= argc || strncmp(arg, "--mock-", 7) != 0) return false;
+  const char *value = argv[i + 1];
+  if (strcmp(arg, "--mock-latency") == 0) latencyMs = atoi(value);
+  else if (strcmp(arg, "--mock-jitter") == 0) jitterMs = atoi(value);
+  else if (strcmp(arg, "--mock-errors") == 0) errorRate = (float)atof(value);
+  else if (strcmp(arg, "--mock-payload") == 0) payloadBytes = atoi(value);
+  else if (strcmp(arg, "--mock-entities") == 0) entityCount = atoi(value);
+  else if (strcmp(arg, "--mock-seed") == 0) seed = (unsigned)strtoul(value, nullptr, 10);
+  else return false;
+  i++;
+  return true;
+}
+
+const char *MockConfig::usage() {
+  return "  --mock-latency MS   delay every response by MS\n"
+         "  --mock-jitter MS    ± uniform jitter around the latency\n"
+         "  --mock-errors RATE  answer this fraction of requests with a 500\n"
+         "  --mock-payload N    pad state and text responses by N bytes\n"
+         "  --mock-entities N   serve a generated dashboard with N entities\n"
+         "  --mock-seed N       seed for jitter and error injection\n";
+}
+
+// "http://host:port/api/x?y=z" -> path "/api/x", query "y=z"
+static void splitUrl(const char *url, std::string &path, std::string &query) {
+  const char *p = strstr(url, "://");
+  p = p ? strchr(p + 3, '/') : url;
+  std::string rest = p ? p : "/";
+  size_t q = rest.find('?');
+  path = rest.substr(0, q);
+  query = q == std::string::npos ? "" : rest.substr(q + 1);
+}
+
+static std::string queryParam(const std::string &query, const char *key) {
+  std::string prefix = std::string(key) + "=";
+  size_t pos = 0;
+  while (pos < query.size()) {
+    size_t end = query.find('&', pos);
+    std::string part = query.substr(pos, end - pos);
+    if (part.compare(0, prefix.size(), prefix) == 0) return part.substr(prefix.size());
+    if (end == std::string::npos) break;
+    pos = end + 1;
+  }
+  return "";
+}
+
+static MockResponse respond(int status, const std::string &body = "") {
+  MockResponse resp;
+  resp.status = status;
+  resp.body = body;
+  return resp;
+}
+
+MockRoutes::MockRoutes(const MockConfig &config)
+    : _config(config), _rng(config.seed) {}
+
+int MockRoutes::sampleDelayMs() {
+  if (_config.jitterMs <= 0) return _config.latencyMs;
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::uniform_int_distribution<int> jitter(-_config.jitterMs, _config.jitterMs);
+  int ms = _config.latencyMs + jitter(_rng);
+  return ms < 0 ? 0 : ms;
+}
+
+MockResponse MockRoutes::handle(const char *method, const char *url,
+                                const char *body, const char *ifNoneMatch) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_config.errorRate > 0.0f) {
+    std::uniform_real_distribution<float> roll(0.0f, 1.0f);
+    if (roll(_rng) < _config.errorRate) {
+      return respond(500, "{\"message\":\"mock error\"}");
+    }
+  }
+
+  std::string path, query;
+  splitUrl(url, path, query);
+  if (strcmp(method, "POST") == 0) return post(path, body);
+  return get(path, query, ifNoneMatch);
+}
+
+std::string &MockRoutes::stateOf(const std::string &entityId) {
+  auto it = _states.find(entityId);
+  if (it != _states.end()) return it->second;
+
+  std::string domain = entityId.substr(0, entityId.find('.'));
+  std::string initial = "off";
+  if (domain == "weather") initial = "sunny";
+  else if (domain == "sensor") initial = "21.5";
+  return _states[entityId] = initial;
+}
+
+void MockRoutes::attributesOf(const std::string &entityId, JsonObject attrs) {
+  attrs["friendly_name"] = entityId;
+  if (entityId.compare(0, 8, "weather.") == 0) {
+    attrs["temperature"] = 21.5;
+    attrs["humidity"] = 40;
+    attrs["wind_speed"] = 3.2;
+  }
+  if (_config.payloadBytes > 0) {
+    attrs["mock_padding"] = std::string(_config.payloadBytes, 'x');
+  }
+}
+
+// As HA's /api/states/<id>, without timestamps and context
+void MockRoutes::stateDocument(const std::string &entityId, JsonObject out) {
+  out["entity_id"] = entityId;
+  out["state"] = stateOf(entityId);
+  attributesOf(entityId, out["attributes"].to<JsonObject>());
+}
+
+std::string MockRoutes::entityState(const std::string &entityId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return stateOf(entityId);
+}
+
+void MockRoutes::entityAttributes(const std::string &entityId, JsonObject attrs) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  attributesOf(entityId, attrs);
+}
+
+unsigned MockRoutes::stateVersion() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stateVersion;
+}
+
+// Drops the attributes not in the comma-separated list, like the control
+// server's ?attrs=
+static void keepAttributes(JsonObject attributes, const std::string &list) {
+  std::string padded = "," + list + ",";
+  std::vector<std::string> dropped;
+  for (JsonPair kv : attributes) {
+    std::string key = kv.key().c_str();
+    if (padded.find("," + key + ",") == std::string::npos) dropped.push_back(key);
+  }
+  for (const std::string &key : dropped) attributes.remove(key);
+}
+
+// One screen of cards cycling through the HA widgets, for sizing tests
+std::string MockRoutes::generatedManifest() {
+  JsonDocument doc;
+  doc["version"] = 1;
+  doc["default_screen"] = 32;
+  JsonObject tab = doc["tabs"].add<JsonObject>();
+  tab["id"] = 32;
+  tab["icon"] = "";
+  tab["label"] = "Mock";
+
+  JsonObject screen = doc["screens"]["32"].to<JsonObject>();
+  screen["type"] = "FlexLayout";
+  screen["props"]["direction"] = "column";
+  screen["props"]["align"] = "center";
+  screen["props"]["gap"] = 12;
+  JsonArray children = screen["children"].to<JsonArray>();
+  JsonObject title = children.add<JsonObject>();
+  title["type"] = "Text";
+  title["props"]["size"] = 4;
+  title["text"] = "Mock dashboard";
+
+  char entity[48];
+  for (int i = 0; i < _config.entityCount; i++) {
+    JsonObject card = children.add<JsonObject>();
+    card["type"] = "Card";
+    JsonObject child = card["children"].to<JsonArray>().add<JsonObject>();
+    switch (i % 3) {
+    case 0:
+      snprintf(entity, sizeof(entity), "light.mock_%d", i);
+      child["type"] = "HAToggle";
+      break;
+    case 1:
+      snprintf(entity, sizeof(entity), "binary_sensor.mock_%d", i);
+      child["type"] = "HABinarySensor";
+      child["label"] = entity;
+      break;
+    default:
+      snprintf(entity, sizeof(entity), "weather.mock_%d", i);
+      child["type"] = "HAWeather";
+      break;
+    }
+    child["entity"] = entity;
+  }
+
+  std::string body;
+  serializeJson(doc, body);
+  return body;
+}
+
+MockResponse MockRoutes::get(const std::string &path, const std::string &query,
+                             const char *ifNoneMatch) {
+  if (path == "/api/ui/screens") {
+    if (_config.manifestPath.empty()) {
+      if (_config.entityCount > 0) return respond(200, generatedManifest());
+      return respond(404);
+    }
+    std::ifstream f(_config.manifestPath, std::ios::binary);
+    if (!f) return respond(404);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return respond(200, ss.str());
+  }
+
+  if (path == "/api/version") {
+    JsonDocument doc;
+    doc["version"] = FIRMWARE_VERSION;
+    std::string body;
+    serializeJson(doc, body);
+    return respond(200, body);
+  }
+
+  const char *statesPrefix = "/api/states/";
+  if (path.compare(0, strlen(statesPrefix), statesPrefix) == 0) {
+    JsonDocument doc;
+    stateDocument(path.substr(strlen(statesPrefix)), doc.to<JsonObject>());
+    std::string body;
+    serializeJson(doc, body);
+    return respond(200, body);
+  }
+
+  // control server batch read: every requested entity is "known" here
+  if (path == "/api/datasources/ha/states") {
+    std::string ids = queryParam(query, "ids");
+    std::string attrs = queryParam(query, "attrs");
+    JsonDocument doc;
+    JsonArray states = doc.to<JsonArray>();
+    size_t pos = 0;
+    while (pos < ids.size()) {
+      size_t end = ids.find(',', pos);
+      if (end == std::string::npos) end = ids.size();
+      if (end > pos) {
+        JsonObject state = states.add<JsonObject>();
+        stateDocument(ids.substr(pos, end - pos), state);
+        if (!attrs.empty()) keepAttributes(state["attributes"], attrs);
+      }
+      pos = end + 1;
+    }
+    std::string body;
+    serializeJson(doc, body);
+    return respond(200, body);
+  }
+
+  if (path == "/api/dynamic/text" || path == "/api/dynamic/llm") {
+    std::string key = queryParam(query, "key");
+    std::string etag = "stub-" + key;
+    if (ifNoneMatch && std::string(ifNoneMatch) == "\"" + etag + "\"") {
+      return respond(304);
+    }
+    JsonDocument doc;
+    doc["text"] = "Stub text " + key;
+    doc["etag"] = etag;
+    if (_config.payloadBytes > 0) {
+      doc["mock_padding"] = std::string(_config.payloadBytes, 'x');
+    }
+    std::string body;
+    serializeJson(doc, body);
+    MockResponse resp = respond(200, body);
+    resp.etag = etag;
+    return resp;
+  }
+
+  return respond(404);
+}
+
+MockResponse MockRoutes::post(const std::string &path, const char *body) {
+  const char *servicesPrefix = "/api/services/";
+  if (path.compare(0, strlen(servicesPrefix), servicesPrefix) == 0) {
+    std::string service = path.substr(path.rfind('/') + 1);
+    JsonDocument req;
+    if (deserializeJson(req, body ? body : "")) return respond(400);
+    std::string entityId = req["entity_id"] | "";
+    std::string &state = stateOf(entityId);
+    std::string before = state;
+    if (service == "turn_on") state = "on";
+    else if (service == "turn_off") state = "off";
+    else if (service == "toggle") state = state == "on" ? "off" : "on";
+    if (state != before) _stateVersion++;
+    return respond(200, "[]");
+  }
+
+  if (path == "/api/dynamic/refresh") return respond(200, "{}");
+
+  return respond(404);
+}
@@ -0,0 +1,85 @@
+#ifndef _MOCK_ROUTES_H_
+#define _MOCK_ROUTES_H_
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include <ArduinoJson.h>
+
+// Knobs shared by StubNetwork (in-process) and round_touch_mock_server
+// (over a socket).
+struct MockConfig {
+  std::string manifestPath; // served as /api/ui/screens; overrides entityCount
+  int latencyMs = 0;        // added to every response
+  int jitterMs = 0;         // ± uniform around latencyMs
+  float errorRate = 0.0f;   // fraction of requests answered with a 500
+  int payloadBytes = 0;     // padding attribute added to state/text bodies
+  int entityCount = 0;      // >0: generated dashboard with this many entities
+  unsigned seed = 1;
+
+  // Consume a --mock-* option at argv[i] (advancing i past its value).
+  // Returns false if argv[i] is not one of ours.
+  bool parseArg(int argc, char *argv[], int &i);
+  static const char *usage();
+};
+
+struct MockResponse {
+  int status = 404;
+  std::string body;
+  std::string etag;
+};
+
+// Deterministic stand-in for Home Assistant and the control server. Routes
+// by path (scheme and host are ignored):
+//
+//   GET  /api/ui/screens         manifest file, or a generated dashboard
+//   GET  /api/version            current FIRMWARE_VERSION (no update toast)
+//   GET  /api/states/<id>        canned entity state, default by domain
+//   GET  /api/datasources/ha/states?ids=a,b[&attrs=x,y]   the same states,
+//                                as one array, attributes trimmed to attrs
+//   POST /api/services/<d>/<s>   turn_on / turn_off / toggle update that state
+//   GET  /api/dynamic/{text,llm} fixed text per key, 304 on matching ETag
+//   POST /api/dynamic/refresh    200
+//
+// The mock server's /api/websocket stand-in reads the same states through
+// entityState()/entityAttributes() and pushes a change whenever
+// stateVersion() moves.
+//
+// Thread-safe; the mock server calls it from one thread per connection.
+class MockRoutes {
+public:
+  explicit MockRoutes(const MockConfig &config = MockConfig());
+
+  MockResponse handle(const char *method, const char *url, const char *body,
+                      const char *ifNoneMatch);
+  // How long to hold the response (latencyMs ± jitterMs)
+  int sampleDelayMs();
+
+  const MockConfig &config() const { return _config; }
+
+  // As served by GET /api/states/<id>
+  std::string entityState(const std::string &entityId);
+  void entityAttributes(const std::string &entityId, JsonObject attrs);
+  // Bumped by every service call that changes a state
+  unsigned stateVersion();
+
+private:
+  MockConfig _config;
+  std::map<std::string, std::string> _states;
+  std::mt19937 _rng;
+  std::mutex _mutex;
+  unsigned _stateVersion = 0;
+
+  MockResponse get(const std::string &path, const std::string &query,
+                   const char *ifNoneMatch);
+  MockResponse post(const std::string &path, const char *body);
+  // called with _mutex held
+  std::string &stateOf(const std::string &entityId);
+  void attributesOf(const std::string &entityId, JsonObject attrs);
+  void stateDocument(const std::string &entityId, JsonObject out);
+  std::string generatedManifest();
+};
+
+#endif // _MOCK_ROUTES_H_
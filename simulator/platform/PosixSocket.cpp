@@ -0,0 +1,91 @@
+#include "platform/PosixSocket.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+
+// Non-blocking connect so the timeout holds, then back to blocking
+static bool connectWithTimeout(int fd, const sockaddr *addr, socklen_t len,
+                               uint32_t timeoutMs) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  int rc = ::connect(fd, addr, len);
+  if (rc < 0 && errno == EINPROGRESS) {
+    pollfd pfd = {fd, POLLOUT, 0};
+    rc = poll(&pfd, 1, (int)timeoutMs) == 1 ? 0 : -1;
+    if (rc == 0) {
+      int err = 0;
+      socklen_t errLen = sizeof(err);
+      getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen);
+      if (err != 0) rc = -1;
+    }
+  }
+  fcntl(fd, F_SETFL, flags);
+  return rc == 0;
+}
+
+bool PosixSocket::connect(const char *host, uint16_t port, uint32_t timeoutMs) {
+  close();
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *addrs = nullptr;
+  char service[8];
+  snprintf(service, sizeof(service), "%u", (unsigned)port);
+  if (getaddrinfo(host, service, &hints, &addrs) != 0) return false;
+
+  for (addrinfo *a = addrs; a != nullptr; a = a->ai_next) {
+    int fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd < 0) continue;
+    if (connectWithTimeout(fd, a->ai_addr, a->ai_addrlen, timeoutMs)) {
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      _fd = fd;
+      break;
+    }
+    ::close(fd);
+  }
+  freeaddrinfo(addrs);
+  return _fd >= 0;
+}
+
+int PosixSocket::read(uint8_t *buf, size_t len, uint32_t timeoutMs) {
+  if (_fd < 0) return -1;
+  pollfd pfd = {_fd, POLLIN, 0};
+  int ready = poll(&pfd, 1, (int)timeoutMs);
+  if (ready == 0) return 0;
+  if (ready < 0) return errno == EINTR ? 0 : -1;
+  ssize_t n = recv(_fd, buf, len, 0);
+  if (n <= 0) {
+    close();
+    return -1;
+  }
+  return (int)n;
+}
+
+bool PosixSocket::write(const uint8_t *data, size_t len) {
+  size_t sent = 0;
+  while (_fd >= 0 && sent < len) {
+    ssize_t n = send(_fd, data + sent, len - sent, MSG_NOSIGNAL);
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) continue;
+      close();
+      return false;
+    }
+    sent += n;
+  }
+  return _fd >= 0;
+}
+
+void PosixSocket::close() {
+  if (_fd < 0) return;
+  ::close(_fd);
+  _fd = -1;
+}
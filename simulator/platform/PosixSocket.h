@@ -0,0 +1,20 @@
+#ifndef _POSIX_SOCKET_H_
+#define _POSIX_SOCKET_H_
+
+#include "device/ISocket.h"
+
+// ISocket over a plain BSD socket, for the desktop simulator
+class PosixSocket : public ISocket {
+  int _fd = -1;
+
+public:
+  ~PosixSocket() override { close(); }
+
+  bool connect(const char *host, uint16_t port, uint32_t timeoutMs) override;
+  bool connected() override { return _fd >= 0; }
+  int read(uint8_t *buf, size_t len, uint32_t timeoutMs) override;
+  bool write(const uint8_t *data, size_t len) override;
+  void close() override;
+};
+
+#endif // _POSIX_SOCKET_H_
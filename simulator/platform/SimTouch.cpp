@@ -1,59 +1,58 @@
+#include <Arduino.h>
 #include "SimTouch.h"
-#include <cmath>
+#include "util/TouchRecorder.h"
 #include <cstdio>
 
-static const int SWIPE_THRESHOLD = 30;
-
 static bool s_mouseDown = false;
-static int s_downX = 0, s_downY = 0;
-static bool s_pendingGesture = false;
-static std::string s_gesture;
-static int s_gestureX = 0, s_gestureY = 0;
+static int s_pointerX = 0, s_pointerY = 0;
+static GestureRecognizer s_gestures;
 
+#ifndef SIM_HEADLESS
 void SimTouch::processEvent(const SDL_Event &event) {
   if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
-    s_mouseDown = true;
-    s_downX = event.button.x;
-    s_downY = event.button.y;
+    press(event.button.x, event.button.y);
+  } else if (event.type == SDL_MOUSEMOTION && s_mouseDown) {
+    move(event.motion.x, event.motion.y);
   } else if (event.type == SDL_MOUSEBUTTONUP && event.button.button == SDL_BUTTON_LEFT) {
-    if (!s_mouseDown) return;
-    s_mouseDown = false;
-
-    int upX = event.button.x;
-    int upY = event.button.y;
-    int dx = upX - s_downX;
-    int dy = upY - s_downY;
-    int dist = (int)std::sqrt(dx * dx + dy * dy);
-
-    if (dist < SWIPE_THRESHOLD) {
-      // Tap
-      s_gesture = "SINGLE CLICK";
-      s_gestureX = s_downX;
-      s_gestureY = s_downY;
-    } else {
-      // Swipe - determine dominant direction
-      if (std::abs(dx) > std::abs(dy)) {
-        s_gesture = dx > 0 ? "SWIPE RIGHT" : "SWIPE LEFT";
-      } else {
-        s_gesture = dy > 0 ? "SWIPE DOWN" : "SWIPE UP";
-      }
-      s_gestureX = s_downX;
-      s_gestureY = s_downY;
-    }
-
-    s_pendingGesture = true;
-    printf("[SimTouch] %s at (%d, %d)\n", s_gesture.c_str(), s_gestureX,
-           s_gestureY);
+    release(event.button.x, event.button.y);
   }
 }
+#endif
+
+static void feed(bool pressed) {
+  s_gestures.sample({(uint32_t)millis(), (uint32_t)micros(), (int16_t)s_pointerX,
+                     (int16_t)s_pointerY, pressed});
+}
 
-bool SimTouch::hasPendingGesture() { return s_pendingGesture; }
+void SimTouch::press(int x, int y) {
+  s_mouseDown = true;
+  s_pointerX = x;
+  s_pointerY = y;
+  TouchRecorder::down(x, y);
+  feed(true);
+}
 
-std::string SimTouch::consumeGesture() {
-  s_pendingGesture = false;
-  return s_gesture;
+void SimTouch::move(int x, int y) {
+  if (!s_mouseDown) return;
+  s_pointerX = x;
+  s_pointerY = y;
+  feed(true);
 }
 
-std::pair<int, int> SimTouch::getGesturePos() {
-  return {s_gestureX, s_gestureY};
+void SimTouch::release(int upX, int upY) {
+  if (!s_mouseDown) return;
+  s_mouseDown = false;
+  s_pointerX = upX;
+  s_pointerY = upY;
+  TouchRecorder::up(upX, upY);
+  printf("[SimTouch] release at (%d, %d)\n", upX, upY);
+  feed(false);
 }
+
+bool SimTouch::pointer(int &x, int &y) {
+  x = s_pointerX;
+  y = s_pointerY;
+  return s_mouseDown;
+}
+
+GestureRecognizer &SimTouch::gestures() { return s_gestures; }
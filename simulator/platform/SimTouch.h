@@ -1,16 +1,27 @@
 #ifndef _SIM_TOUCH_H_
 #define _SIM_TOUCH_H_
 
+#ifndef SIM_HEADLESS
 #include <SDL2/SDL.h>
-#include <string>
-#include <utility>
+#endif
+
+#include "device/gesture/GestureRecognizer.h"
 
 class SimTouch {
 public:
+#ifndef SIM_HEADLESS
   static void processEvent(const SDL_Event &event);
-  static bool hasPendingGesture();
-  static std::string consumeGesture();
-  static std::pair<int, int> getGesturePos();
+#endif
+  // Backend-agnostic contact input (SDL mouse or a headless touch script)
+  static void press(int x, int y);
+  static void move(int x, int y);
+  static void release(int x, int y);
+
+  // Live contact state for the LVGL pointer; returns true while pressed
+  static bool pointer(int &x, int &y);
+
+  // Fed by press/move/release, drained by SimTouchDriver
+  static GestureRecognizer &gestures();
 };
 
 #endif // _SIM_TOUCH_H_
@@ -0,0 +1,79 @@
+#include "platform/StubNetwork.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "util/AllocTracker.h"
+
+static bool s_enabled = false;
+
+MockConfig &StubNetwork::config() {
+  static MockConfig config;
+  return config;
+}
+
+void StubNetwork::enable(const char *manifestPath) {
+  s_enabled = true;
+  if (manifestPath) config().manifestPath = manifestPath;
+}
+
+bool StubNetwork::enabled() { return s_enabled; }
+
+StubNetwork::StubNetwork() : _routes(config()) {}
+
+void StubNetwork::init() {
+  const MockConfig &c = _routes.config();
+  printf("[StubNetwork] Offline network (manifest: %s, latency %d±%d ms, "
+         "errors %.0f%%)\n",
+         c.manifestPath.empty() ? (c.entityCount > 0 ? "generated" : "none")
+                                : c.manifestPath.c_str(),
+         c.latencyMs, c.jitterMs, c.errorRate * 100.0f);
+}
+
+bool StubNetwork::isConnected() { return true; }
+
+HttpResponse StubNetwork::finish(const MockResponse &mock, uint32_t timeoutMs) {
+  int ms = _routes.sampleDelayMs();
+  // a deadline shorter than the simulated latency times out like a real one
+  bool late = timeoutMs > 0 && ms > (int)timeoutMs;
+  if (late) ms = (int)timeoutMs;
+#ifdef SIM_HEADLESS
+  if (ms > 0) delay(ms);
+#else
+  // runs on a network worker: a plain sleep, since delay() pumps SDL
+  // events, which only the main thread may do
+  if (ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+
+  HttpResponse resp;
+  if (late) {
+    resp.statusCode = HTTP_ERROR_DEADLINE;
+    return resp;
+  }
+  resp.statusCode = mock.status;
+  // the one copy a real driver makes off the wire
+  if (!resp.body.assign(mock.body.data(), mock.body.size())) {
+    resp.statusCode = HTTP_ERROR_TOO_LARGE;
+    return resp;
+  }
+  resp.etag = String(mock.etag.c_str());
+  return resp;
+}
+
+// MockRoutes is thread-safe, so the pool's workers share it
+HttpResponse StubNetwork::perform(const HttpRequest &req, uint32_t timeoutMs) {
+  AllocScope scope(AllocPhase::Network);
+  HttpResponse resp;
+  if (req.method == HttpRequest::Method::Post) {
+    resp = finish(_routes.handle("POST", req.url.c_str(), req.body.c_str(), nullptr),
+                  timeoutMs);
+  } else {
+    const char *ifNoneMatch =
+        req.ifNoneMatch.length() > 0 ? req.ifNoneMatch.c_str() : nullptr;
+    resp = finish(_routes.handle("GET", req.url.c_str(), nullptr, ifNoneMatch),
+                  timeoutMs);
+  }
+  INetwork::streamBuffered(req, resp);
+  return resp;
+}
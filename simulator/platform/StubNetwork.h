@@ -0,0 +1,37 @@
+#ifndef _STUB_NETWORK_H_
+#define _STUB_NETWORK_H_
+
+#include "device/network/PooledNetwork.h"
+#include "platform/MockRoutes.h"
+
+// Offline, deterministic INetwork for replay and benchmark runs. Answers
+// in-process from MockRoutes (see MockRoutes.h for the routes served).
+//
+// With the default config responses are immediate, so replayed sessions
+// time only the firmware. Configured latency is slept on a network worker
+// in the SDL build; headless runs spend it in delay(), advancing the
+// virtual clock while the request runs inline.
+class StubNetwork : public PooledNetwork {
+public:
+  // Select the stub for the next Device; manifestPath may be null
+  static void enable(const char *manifestPath);
+  static bool enabled();
+  // Latency / error / payload knobs, read when the Device is created
+  static MockConfig &config();
+
+  StubNetwork();
+  ~StubNetwork() override { stopWorkers(); }
+
+  void init() override;
+  bool isConnected() override;
+
+protected:
+  HttpResponse perform(const HttpRequest &req, uint32_t timeoutMs) override;
+
+private:
+  MockRoutes _routes;
+
+  HttpResponse finish(const MockResponse &mock, uint32_t timeoutMs);
+};
+
+#endif // _STUB_NETWORK_H_
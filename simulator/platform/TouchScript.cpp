@@ -0,0 +1,84 @@
+#include "platform/TouchScript.h"
+#include "platform/SimTouch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const unsigned long DEFAULT_SWIPE_MS = 150;
+// roughly one pointer sample per display refresh
+static const unsigned long SCRIPT_MOVE_INTERVAL_MS = 16;
+
+bool TouchScript::load(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    printf("[TouchScript] Cannot open %s\n", path);
+    return false;
+  }
+
+  _steps.clear();
+  _next = 0;
+
+  char line[256];
+  int lineNo = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNo++;
+    char *p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    // recordings captured from a device serial log
+    if (strncmp(p, "[TouchRec] ", 11) == 0) p += 11;
+    else if (*p == '[') continue;
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+    unsigned long ms = 0;
+    char kind[16] = {0};
+    int a = 0, b = 0, c = 0, d = 0;
+    unsigned long dur = DEFAULT_SWIPE_MS;
+    int n = sscanf(p, "%lu %15s %d %d %d %d %lu", &ms, kind, &a, &b, &c, &d, &dur);
+
+    if (n >= 4 && strcmp(kind, "tap") == 0) {
+      _steps.push_back({ms, StepType::Down, a, b});
+      _steps.push_back({ms, StepType::Up, a, b});
+    } else if (n >= 6 && strcmp(kind, "swipe") == 0) {
+      _steps.push_back({ms, StepType::Down, a, b});
+      for (unsigned long t = SCRIPT_MOVE_INTERVAL_MS; t < dur; t += SCRIPT_MOVE_INTERVAL_MS) {
+        int x = a + (int)((long)(c - a) * (long)t / (long)dur);
+        int y = b + (int)((long)(d - b) * (long)t / (long)dur);
+        _steps.push_back({ms + t, StepType::Move, x, y});
+      }
+      _steps.push_back({ms + dur, StepType::Up, c, d});
+    } else if (n >= 4 && strcmp(kind, "down") == 0) {
+      _steps.push_back({ms, StepType::Down, a, b});
+    } else if (n >= 4 && strcmp(kind, "move") == 0) {
+      _steps.push_back({ms, StepType::Move, a, b});
+    } else if (n >= 4 && strcmp(kind, "up") == 0) {
+      _steps.push_back({ms, StepType::Up, a, b});
+    } else {
+      printf("[TouchScript] %s:%d: cannot parse '%s'\n", path, lineNo, p);
+    }
+  }
+  fclose(f);
+
+  // stable so a tap's down/up pair keeps its order
+  std::stable_sort(_steps.begin(), _steps.end(),
+                   [](const Step &l, const Step &r) { return l.ms < r.ms; });
+  printf("[TouchScript] Loaded %zu steps from %s\n", _steps.size(), path);
+  return true;
+}
+
+void TouchScript::apply(unsigned long nowMs) {
+  while (_next < _steps.size() && _steps[_next].ms <= nowMs) {
+    const Step &s = _steps[_next++];
+    if (s.type == StepType::Down) {
+      SimTouch::press(s.x, s.y);
+    } else if (s.type == StepType::Move) {
+      SimTouch::move(s.x, s.y);
+    } else {
+      SimTouch::release(s.x, s.y);
+    }
+  }
+}
+
+unsigned long TouchScript::nextAt() const {
+  return done() ? 0 : _steps[_next].ms;
+}
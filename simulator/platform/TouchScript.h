@@ -0,0 +1,44 @@
+#ifndef _TOUCH_SCRIPT_H_
+#define _TOUCH_SCRIPT_H_
+
+#include <cstddef>
+#include <vector>
+
+// Timed touch input for the headless simulator. One step per line,
+// timestamps are virtual milliseconds since start:
+//
+//   # comment
+//   500  tap   120 120
+//   1500 swipe 120 40 120 200 [duration_ms]
+//   2500 down  60 60
+//   2550 move  60 90
+//   2600 up    60 90
+//
+// Steps are fed to SimTouch as press/move/release contacts, so the same
+// gesture detection runs as for SDL mouse input. Swipes are expanded into
+// ~60 Hz moves so LVGL's pointer sees a drag rather than a jump. Files
+// written by TouchRecorder load directly; in captured serial logs,
+// "[TouchRec] " lines are used and other "[Tag] ..." log lines are skipped.
+class TouchScript {
+public:
+  bool load(const char *path);
+  // Apply every step due at or before nowMs
+  void apply(unsigned long nowMs);
+  bool done() const { return _next >= _steps.size(); }
+  unsigned long nextAt() const;
+  unsigned long lastAt() const { return _steps.empty() ? 0 : _steps.back().ms; }
+  size_t size() const { return _steps.size(); }
+
+private:
+  enum class StepType { Down, Move, Up };
+  struct Step {
+    unsigned long ms;
+    StepType type;
+    int x, y;
+  };
+
+  std::vector<Step> _steps;
+  size_t _next = 0;
+};
+
+#endif // _TOUCH_SCRIPT_H_
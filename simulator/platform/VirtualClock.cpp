@@ -0,0 +1,9 @@
+#include "platform/VirtualClock.h"
+
+static unsigned long s_now = 0;
+
+unsigned long VirtualClock::now() { return s_now; }
+
+void VirtualClock::advance(unsigned long ms) { s_now += ms; }
+
+void VirtualClock::reset() { s_now = 0; }
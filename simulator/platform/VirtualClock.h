@@ -0,0 +1,14 @@
+#ifndef _VIRTUAL_CLOCK_H_
+#define _VIRTUAL_CLOCK_H_
+
+// Deterministic time source for the headless simulator.
+// millis() reads it and delay() advances it, so a run produces the same
+// timer/animation sequence regardless of host speed.
+class VirtualClock {
+public:
+  static unsigned long now();
+  static void advance(unsigned long ms);
+  static void reset();
+};
+
+#endif // _VIRTUAL_CLOCK_H_
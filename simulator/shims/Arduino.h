@@ -1,15 +1,22 @@
 #ifndef _ARDUINO_SHIM_H_
 #define _ARDUINO_SHIM_H_
 
+#ifndef SIM_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
 #include <algorithm>
 #include <string>
+#include <chrono>
 
+#ifdef SIM_HEADLESS
+#include "platform/VirtualClock.h"
+#else
 #include "platform/SimTouch.h"
+#endif
 
 // --- Types ---
 typedef uint8_t byte;
@@ -27,8 +34,23 @@ inline int digitalRead(int) { return 0; }
 inline int analogRead(int) { return 0; }
 
 // --- Timing ---
+#ifdef SIM_HEADLESS
+// Headless builds run on a virtual clock: delay() returns immediately and
+// moves time forward, so LVGL timers and animations fire deterministically.
+// micros() stays on the host clock: it is only used for profiling, where
+// the real cost of a loop is what we want to measure.
+inline unsigned long millis() { return VirtualClock::now(); }
+inline unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline void delay(unsigned long ms) { VirtualClock::advance(ms); }
+#else
 inline unsigned long millis() { return SDL_GetTicks(); }
-inline unsigned long micros() { return SDL_GetTicks() * 1000; }
+inline unsigned long micros() {
+  return (unsigned long)(SDL_GetPerformanceCounter() * 1000000.0 /
+                         SDL_GetPerformanceFrequency());
+}
 
 inline void delay(unsigned long ms) {
   unsigned long start = SDL_GetTicks();
@@ -41,6 +63,7 @@ inline void delay(unsigned long ms) {
     SDL_Delay(1);
   }
 }
+#endif
 
 inline void delayMicroseconds(unsigned long) {}
 
@@ -111,6 +134,7 @@ public:
   bool operator==(const String &other) const { return _s == other._s; }
   bool operator!=(const char *other) const { return _s != other; }
   bool operator!=(const String &other) const { return _s != other._s; }
+  bool operator<(const String &other) const { return _s < other._s; }
 
   String operator+(const String &other) const { return String(_s + other._s); }
   String operator+(const char *other) const { return String(_s + other); }
@@ -3,11 +3,72 @@
 
 #include "device/IDisplay.h"
 #include "device/ITouch.h"
+#include "device/gesture/GestureEvents.h"
 #include "device/IStorage.h"
 #include "device/types/TouchLocation.h"
 #include "events/types/TouchEvent.h"
 #include "platform/SimTouch.h"
 
+#ifdef SIM_HEADLESS
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define MEMORY_DISPLAY_BUF_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT / 10)
+
+// Headless display - LVGL renders into an in-memory RGB565 framebuffer.
+// Uses the same partial double-buffer layout as the GC9A01 driver so
+// render/flush cost is comparable to hardware.
+class MemoryDisplayDriver : public IDisplay {
+private:
+  lv_display_t *_disp = nullptr;
+  uint16_t *_buf1 = nullptr;
+  uint16_t *_buf2 = nullptr;
+  std::vector<uint16_t> _framebuffer;
+  uint32_t _flushCount = 0;
+
+  static void flushCb(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
+    auto *self = (MemoryDisplayDriver *)lv_display_get_user_data(disp);
+    const uint16_t *src = (const uint16_t *)px;
+    int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+      memcpy(&self->_framebuffer[y * SCREEN_WIDTH + area->x1], src,
+             w * sizeof(uint16_t));
+      src += w;
+    }
+    self->_flushCount++;
+    lv_display_flush_ready(disp);
+  }
+
+public:
+  ~MemoryDisplayDriver() {
+    free(_buf1);
+    free(_buf2);
+  }
+
+  void init() override { _framebuffer.assign(SCREEN_WIDTH * SCREEN_HEIGHT, 0); }
+  int width() override { return SCREEN_WIDTH; }
+  int height() override { return SCREEN_HEIGHT; }
+
+  lv_display_t *initLVGL() override {
+    _disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_display_set_user_data(_disp, this);
+    lv_display_set_flush_cb(_disp, flushCb);
+    lv_display_set_color_format(_disp, LV_COLOR_FORMAT_RGB565);
+
+    size_t buf_bytes = MEMORY_DISPLAY_BUF_SIZE * sizeof(uint16_t);
+    _buf1 = (uint16_t *)malloc(buf_bytes);
+    _buf2 = (uint16_t *)malloc(buf_bytes);
+    lv_display_set_buffers(_disp, _buf1, _buf2, buf_bytes,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    return _disp;
+  }
+
+  const uint16_t *framebuffer() const { return _framebuffer.data(); }
+  uint32_t flushCount() const { return _flushCount; }
+};
+#else
 // Simulator display - LVGL renders via its built-in SDL driver
 class SimDisplayDriver : public IDisplay {
 public:
@@ -19,37 +80,22 @@ public:
     return lv_sdl_window_create(SCREEN_WIDTH, SCREEN_HEIGHT);
   }
 };
+#endif
 
-// Simulator touch wraps SimTouch
+// Simulator touch wraps SimTouch (fed by SDL mouse or a headless TouchScript)
 class SimTouchDriver : public ITouch {
 public:
   void init() override {}
 
-  void pollEvent(EventHandler<InputEvent> *handler) override {
-    if (!SimTouch::hasPendingGesture()) return;
+  bool pointer(TouchLocation &location) override {
+    return SimTouch::pointer(location.x, location.y);
+  }
 
-    auto pos = SimTouch::getGesturePos();
-    std::string gestureStr = SimTouch::consumeGesture();
-    String gesture(gestureStr.c_str());
+  bool gesturesPending() override { return SimTouch::gestures().active(); }
 
-    if (gesture == "SINGLE CLICK") {
-      TouchLocation loc = {pos.first, pos.second};
-      TapTouchEvent event = TapTouchEvent(loc);
-      handler->handleEvent(event);
-      return;
-    }
-    if (gesture == "SWIPE UP" || gesture == "SWIPE DOWN" ||
-        gesture == "SWIPE LEFT" || gesture == "SWIPE RIGHT") {
-      SwipeDirection direction = SwipeDirection::UnknownDirection;
-      if (gesture == "SWIPE UP") direction = SwipeDirection::SwipeUp;
-      else if (gesture == "SWIPE DOWN") direction = SwipeDirection::SwipeDown;
-      else if (gesture == "SWIPE LEFT") direction = SwipeDirection::SwipeLeft;
-      else if (gesture == "SWIPE RIGHT") direction = SwipeDirection::SwipeRight;
-      TouchLocation loc = {pos.first, pos.second};
-      SwipeTouchEvent event = SwipeTouchEvent(direction, loc);
-      handler->handleEvent(event);
-      return;
-    }
+  void pollEvent(EventHandler<InputEvent> *handler) override {
+    SimTouch::gestures().tick(millis());
+    GestureEvents::deliver(SimTouch::gestures(), handler);
   }
 };
 
@@ -1,10 +1,13 @@
 #include <Arduino.h>
 
 #include "application/Application.h"
+#include "application/LoopScheduler.h"
 #include "application/interface/Toast.h"
+#include "application/services/ServiceExecutor.h"
 #include "config/NetworkConfig.h"
 #include "config/Version.h"
 #include "ui/registry/ComponentFactories.h"
+#include "util/RenderProfiler.h"
 
 Device *Application::device() { return _device; }
 Workflow &Application::workflow() { return _workflow; }
@@ -16,13 +19,16 @@ ComponentRegistry &Application::registry() { return _registry; }
 UserScreenManager &Application::userScreenManager() { return _userScreenManager; }
 
 void Application::init() {
+  LoopScheduler::begin();
+  ServiceExecutor::begin();
   // subscribe interface to workflow events
   eventhub().workflowEvents().subscribe(&interface());
   // register all component factories for JSON pipeline
   registerAllComponents(_registry);
   // initialize Home Assistant service if network is available
   if (device()->network().isConnected()) {
-    _ha = new HomeAssistant(&device()->network(), HA_BASE_URL, HA_ACCESS_TOKEN);
+    _ha = new HomeAssistant(&device()->network(), HA_BASE_URL, HA_ACCESS_TOKEN,
+                            OTA_UPDATE_URL);
     Serial.println("Home Assistant service initialized.");
   } else {
     Serial.println("Network not connected — HA service unavailable.");
@@ -43,6 +49,7 @@ void Application::init() {
       if (_userScreenManager.loadManifest(resp.body.c_str())) {
         defaultScreen = _userScreenManager.defaultScreen();
         Serial.println("UI manifest loaded from server.");
+        if (_ha != nullptr) _ha->watchEntities(_userScreenManager.entityIds());
       }
     } else {
       Serial.printf("UI manifest fetch failed (HTTP %d)\n", resp.statusCode);
@@ -50,18 +57,25 @@ void Application::init() {
   }
   // navigate to first user screen (manifest default or fallback)
   workflow().navigate(defaultScreen);
-  // check for firmware updates on boot and show toast if available
-  if (_ota != nullptr && _ota->checkForUpdate()) {
-    char msg[64];
-    snprintf(msg, sizeof(msg), "Firmware v%s available",
-             _ota->availableVersion().c_str());
-    Toast::show(msg, {
-      .label = "Update",
-      .callback = [](void *ctx) {
-        auto *self = static_cast<Application *>(ctx);
-        self->workflow().navigate(SYSTEM_SHADE);
-      },
-      .userData = this,
+  // check for firmware updates in the background and show a toast if one
+  // is available; the first screen is already up by then
+  if (_ota != nullptr) {
+    OTAUpdate *ota = _ota;
+    ServiceExecutor::post([this, ota]() {
+      if (!ota->checkForUpdate()) return;
+      String version = ota->availableVersion();
+      ServiceExecutor::toUI([this, version]() {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Firmware v%s available", version.c_str());
+        Toast::show(msg, {
+          .label = "Update",
+          .callback = [](void *ctx) {
+            auto *self = static_cast<Application *>(ctx);
+            self->workflow().navigate(SYSTEM_SHADE);
+          },
+          .userData = this,
+        });
+      });
     });
   }
   Serial.println("Initialized Application.");
@@ -70,19 +84,34 @@ void Application::init() {
 Application::~Application() {
   // unsubscribe interface from events at the end of lifecycle
   eventhub().workflowEvents().unsubscribe(&interface());
+  // services may be mid-request on the worker
+  ServiceExecutor::end();
   delete _ota;
   delete _ha;
 }
 
 void Application::loop() {
+  RenderProfiler::beginLoop();
   // our device has a touch screen which produces
   // touch events. since this is a very high volume event stream
   // poll for new events and pass them to the interface
   // when we have processing time, instead of subscribing
   // directly to the event stream.
-  device()->touchscreen().pollEvent(&interface());
+  {
+    ProfileScope scope(ProfileStage::Touch);
+    device()->touchscreen().pollEvent(&interface());
+    device()->touchscreen().updateLVGL();
+  }
+  // deliver workflow events posted since the last loop
+  eventhub().workflowEvents().drain();
+  // apply results of finished background work (HA state, fetched text)
+  ServiceExecutor::drain();
   // if there is anything new to show, refresh the interface
-  interface().loop();
-  // sleep for a bit, we don't need immediate updates
-  delay(20);
-}
\ No newline at end of file
+  uint32_t nextTimerMs = interface().loop();
+  RenderProfiler::endLoop();
+  // sleep until the next LVGL timer is due, or less if input is live;
+  // touch interrupts and finished background work end the sleep early
+  LoopScheduler::sleep(nextTimerMs, device()->touchscreen().active(),
+                       eventhub().workflowEvents().size() > 0 ||
+                           ServiceExecutor::pending());
+}
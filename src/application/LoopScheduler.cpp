@@ -0,0 +1,55 @@
+#include <Arduino.h>
+
+#include "application/LoopScheduler.h"
+#include "util/WakeSignal.h"
+
+#if defined(LOOP_LIGHT_SLEEP) && !defined(BOARD_SIMULATOR)
+#include <driver/gpio.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+
+#include "BoardConfig.h"
+#endif
+
+void LoopScheduler::begin() {
+#if defined(LOOP_LIGHT_SLEEP) && !defined(BOARD_SIMULATOR)
+  esp_pm_config_t pm = {};
+  pm.max_freq_mhz = getCpuFrequencyMhz();
+  pm.min_freq_mhz = 40;
+  pm.light_sleep_enable = true;
+  esp_err_t err = esp_pm_configure(&pm);
+  if (err != ESP_OK) {
+    Serial.printf("[Loop] Light sleep unavailable (%s)\n", esp_err_to_name(err));
+    return;
+  }
+  // The touch controller pulls INT low on contact: wake on it, and the
+  // driver's interrupt then cuts the loop's wait short
+  err = gpio_wakeup_enable((gpio_num_t)TOUCH_INT, GPIO_INTR_LOW_LEVEL);
+  if (err == ESP_OK) err = esp_sleep_enable_gpio_wakeup();
+  if (err != ESP_OK) {
+    Serial.printf("[Loop] Touch wake unavailable (%s)\n", esp_err_to_name(err));
+  }
+  Serial.println("[Loop] Automatic light sleep enabled.");
+#endif
+}
+
+uint32_t LoopScheduler::budget(uint32_t lvglNextMs, bool inputActive,
+                               bool eventsPending) {
+  if (eventsPending) return 0;
+  uint32_t ms = LOOP_MAX_IDLE_MS;
+  // LV_NO_TIMER_READY (no timers at all) is larger than any cap
+  if (lvglNextMs < ms) ms = lvglNextMs;
+  if (inputActive && ms > LOOP_INPUT_ACTIVE_MS) ms = LOOP_INPUT_ACTIVE_MS;
+  return ms;
+}
+
+void LoopScheduler::sleep(uint32_t lvglNextMs, bool inputActive,
+                          bool eventsPending) {
+  uint32_t ms = budget(lvglNextMs, inputActive, eventsPending);
+#ifndef SIM_HEADLESS
+  // a timer is due or events are queued: go straight round again
+  if (ms == 0) return;
+#endif
+  // (headless always waits: the virtual clock has to move)
+  WakeSignal::wait(ms);
+}
@@ -0,0 +1,31 @@
+#ifndef _LOOP_SCHEDULER_H_
+#define _LOOP_SCHEDULER_H_
+
+#include <stdint.h>
+
+// Longest sleep when nothing is scheduled; input and background fetches
+// wake the loop early through WakeSignal
+#define LOOP_MAX_IDLE_MS 1000
+// Cadence while a finger is down, a gesture timer runs or a scroll throws
+#define LOOP_INPUT_ACTIVE_MS 10
+
+// Decides how long Application::loop may sleep: until the next LVGL timer
+// (lv_timer_handler's return), zero while work is queued, and at frame
+// cadence while input is live.
+//
+// -DLOOP_LIGHT_SLEEP (ESP32, SPI-display boards) enables automatic light
+// sleep through the power-management driver, so those waits draw
+// light-sleep current while Wi-Fi stays associated. The touch INT line is
+// a wake source, so a touch ends the sleep at once. RGB-panel boards keep
+// the panel's PM lock and never sleep.
+class LoopScheduler {
+public:
+  static void begin();
+
+  // Sleep budget in ms for the current pass
+  static uint32_t budget(uint32_t lvglNextMs, bool inputActive, bool eventsPending);
+  // Sleep for budget(...), returning early on WakeSignal::notify()
+  static void sleep(uint32_t lvglNextMs, bool inputActive, bool eventsPending);
+};
+
+#endif // _LOOP_SCHEDULER_H_
@@ -0,0 +1,65 @@
+#include "application/async/Async.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Async {
+
+// tasks waiting for the next refresh, and those being resumed from this one
+static std::vector<NextFrame *> s_waiting;
+static std::vector<NextFrame *> s_ready;
+static lv_display_t *s_display = nullptr;
+
+static void erase(std::vector<NextFrame *> &list, NextFrame *frame) {
+  list.erase(std::remove(list.begin(), list.end(), frame), list.end());
+}
+
+static void onRefreshReady(lv_event_t *) {
+  if (s_waiting.empty()) return;
+  s_ready.swap(s_waiting);
+  // pop one at a time: a resumed task may cancel another waiter
+  while (!s_ready.empty()) {
+    NextFrame *frame = s_ready.front();
+    s_ready.erase(s_ready.begin());
+    frame->resume();
+  }
+}
+
+void NextFrame::await_suspend(std::coroutine_handle<> h) {
+  waiting = h;
+  queued = true;
+  s_waiting.push_back(this);
+  lv_display_t *disp = lv_display_get_default();
+  if (disp == nullptr) return;
+  if (disp != s_display) {
+    s_display = disp;
+    lv_display_add_event_cb(disp, onRefreshReady, LV_EVENT_REFR_READY, nullptr);
+  }
+  // the refresh timer pauses while nothing is invalid; make sure it runs
+  lv_timer_t *refr = lv_display_get_refr_timer(disp);
+  if (refr != nullptr) lv_timer_resume(refr);
+}
+
+void NextFrame::resume() {
+  queued = false;
+  waiting.resume();
+}
+
+NextFrame::~NextFrame() {
+  if (!queued) return;
+  erase(s_waiting, this);
+  erase(s_ready, this);
+}
+
+NetworkCall<HttpResponse> get(INetwork *net, const char *url,
+                              const char *authHeader,
+                              const char *ifNoneMatch) {
+  HttpRequest req;
+  req.url = url;
+  if (authHeader) req.authHeader = authHeader;
+  if (ifNoneMatch) req.ifNoneMatch = ifNoneMatch;
+  return NetworkCall<HttpResponse>(net, std::move(req),
+                                   [](HttpResponse &resp) { return std::move(resp); });
+}
+
+} // namespace Async
@@ -0,0 +1,81 @@
+#ifndef _ASYNC_H_
+#define _ASYNC_H_
+
+#include <coroutine>
+#include <stdint.h>
+
+#include "lvgl.h"
+
+#include "application/async/NetworkCall.h"
+#include "application/async/ServiceCall.h"
+#include "application/async/Task.h"
+#include "device/INetwork.h"
+
+// Awaitables for Tasks, driven by the LVGL timer loop:
+//
+//   co_await Async::sleep(ms);        // an LVGL one-shot timer
+//   co_await Async::nextFrame();      // after the next display refresh
+//   co_await Async::get(net, url);    // queued HTTP GET, nothing blocks
+//
+// Destroying a suspended task (TaskScope cancel) destroys its awaiter,
+// which withdraws the pending timer or frame wait.
+namespace Async {
+
+class Sleep {
+  uint32_t ms;
+  lv_timer_t *timer = nullptr;
+  std::coroutine_handle<> waiting;
+
+  static void fire(lv_timer_t *t) {
+    auto *self = static_cast<Sleep *>(lv_timer_get_user_data(t));
+    self->timer = nullptr; // one-shot, LVGL deletes it after this call
+    self->waiting.resume();
+  }
+
+public:
+  explicit Sleep(uint32_t ms) : ms(ms) {}
+  Sleep(const Sleep &) = delete;
+  Sleep &operator=(const Sleep &) = delete;
+  ~Sleep() {
+    if (timer != nullptr) lv_timer_delete(timer);
+  }
+
+  // even sleep(0) yields to the loop
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> h) {
+    waiting = h;
+    timer = lv_timer_create(fire, ms, this);
+    lv_timer_set_repeat_count(timer, 1);
+  }
+  void await_resume() const noexcept {}
+};
+
+class NextFrame {
+  std::coroutine_handle<> waiting;
+  bool queued = false;
+
+public:
+  NextFrame() = default;
+  NextFrame(const NextFrame &) = delete;
+  NextFrame &operator=(const NextFrame &) = delete;
+  ~NextFrame();
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> h);
+  void await_resume() const noexcept {}
+
+  // called from the display's LV_EVENT_REFR_READY
+  void resume();
+};
+
+inline Sleep sleep(uint32_t ms) { return Sleep(ms); }
+inline NextFrame nextFrame() { return NextFrame(); }
+
+// GET through the network's request queue; url and headers are copied
+NetworkCall<HttpResponse> get(INetwork *net, const char *url,
+                              const char *authHeader = nullptr,
+                              const char *ifNoneMatch = nullptr);
+
+} // namespace Async
+
+#endif // _ASYNC_H_
@@ -0,0 +1,67 @@
+#ifndef _NETWORK_CALL_H_
+#define _NETWORK_CALL_H_
+
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "application/services/ServiceExecutor.h"
+#include "device/INetwork.h"
+
+// Awaitable over INetwork::request(): the request is queued with its
+// priority and deadline, parse() turns the response into R on the network
+// thread (so JSON never parses on the UI loop), and the awaiting Task
+// resumes on the UI loop with the result:
+//
+//   String state = co_await NetworkCall<String>(net, req, parseState);
+//
+// Services with their own request path (coalescing, caching) pass a start
+// function instead, which must call deliver(result) exactly once, from any
+// thread.
+//
+// No thread blocks while the request is in flight. If the awaiting task is
+// cancelled meanwhile, the result is dropped.
+template <typename R>
+class NetworkCall {
+public:
+  using Deliver = std::function<void(R)>;
+  using Start = std::function<void(Deliver)>;
+
+private:
+  Start start;
+  Lifetime lifetime;
+  R result{};
+
+public:
+  NetworkCall(INetwork *net, HttpRequest req,
+              std::function<R(HttpResponse &)> parse)
+      : start([net, req = std::move(req),
+               parse = std::move(parse)](Deliver deliver) mutable {
+          net->request(std::move(req), [parse = std::move(parse),
+                                        deliver = std::move(deliver)](HttpResponse &resp) {
+            deliver(parse(resp));
+          });
+        }) {}
+
+  explicit NetworkCall(Start start) : start(std::move(start)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> waiting) {
+    std::weak_ptr<bool> alive = lifetime.watch();
+    start([this, alive, waiting](R r) {
+      if (alive.expired()) return;
+      auto parsed = std::make_shared<R>(std::move(r));
+      ServiceExecutor::toUI([this, alive, waiting, parsed]() {
+        if (alive.expired()) return;
+        result = std::move(*parsed);
+        waiting.resume();
+      });
+    });
+  }
+
+  R await_resume() { return std::move(result); }
+};
+
+#endif // _NETWORK_CALL_H_
@@ -0,0 +1,41 @@
+#ifndef _SERVICE_CALL_H_
+#define _SERVICE_CALL_H_
+
+#include <coroutine>
+#include <functional>
+#include <utility>
+
+#include "application/services/ServiceExecutor.h"
+
+// Awaitable that runs work() on the ServiceExecutor worker and resumes the
+// awaiting Task on the UI loop with its result:
+//
+//   String state = co_await ServiceCall<String>([ha, id]() {
+//     return ha->getEntityState(id.c_str());
+//   });
+//
+// work() runs off the UI loop, so it must capture what it needs by value.
+// If the awaiting task is cancelled while the call is in flight, the
+// result is dropped instead of resuming a destroyed coroutine.
+template <typename R>
+class ServiceCall {
+  std::function<R()> work;
+  Lifetime lifetime;
+  R result{};
+
+public:
+  explicit ServiceCall(std::function<R()> work) : work(std::move(work)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> waiting) {
+    ServiceExecutor::run(lifetime, std::move(work), [this, waiting](R &r) {
+      result = std::move(r);
+      waiting.resume();
+    });
+  }
+
+  R await_resume() { return std::move(result); }
+};
+
+#endif // _SERVICE_CALL_H_
@@ -0,0 +1,109 @@
+#ifndef _TASK_H_
+#define _TASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+class TaskScope;
+
+// A fire-and-forget coroutine that runs on the UI loop. Write one as a
+// member function returning Task and hand it to a TaskScope:
+//
+//   Task load() {
+//     co_await Async::sleep(100);
+//     entityState = co_await app->ha()->state(id);
+//     update();
+//   }
+//   ...
+//   tasks.spawn(load());
+//
+// Tasks start when spawned and free themselves when they finish. Between
+// co_awaits the loop keeps running; every resume happens on the UI loop
+// (from an LVGL timer, the display refresh or ServiceExecutor::drain), so
+// a task may touch widgets freely.
+class Task {
+public:
+  struct promise_type {
+    TaskScope *scope = nullptr;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    // lazy: TaskScope::spawn starts it once it is tracked
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    // the frame frees itself on completion
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+    ~promise_type();
+  };
+
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  // never spawned: the coroutine body never runs
+  ~Task() {
+    if (handle) handle.destroy();
+  }
+
+private:
+  using Handle = std::coroutine_handle<promise_type>;
+  Handle handle;
+
+  explicit Task(Handle handle) : handle(handle) {}
+  friend class TaskScope;
+};
+
+// Owns the tasks a component spawns. Destroying the scope (with its
+// component) cancels them: each suspended coroutine is destroyed where it
+// waits, and its pending sleep, frame wait or service call is dropped, so
+// nothing resumes into a deleted component. Don't destroy a scope from
+// inside one of its own tasks.
+class TaskScope {
+public:
+  TaskScope() = default;
+  TaskScope(const TaskScope &) = delete;
+  TaskScope &operator=(const TaskScope &) = delete;
+  ~TaskScope() { cancel(); }
+
+  // Start task; it runs until its first co_await before this returns
+  void spawn(Task task) {
+    Task::Handle h = std::exchange(task.handle, nullptr);
+    h.promise().scope = this;
+    running.push_back(h);
+    h.resume();
+  }
+
+  void cancel() {
+    std::vector<Task::Handle> tasks;
+    tasks.swap(running);
+    for (Task::Handle h : tasks) {
+      h.promise().scope = nullptr;
+      h.destroy();
+    }
+  }
+
+  bool empty() const { return running.empty(); }
+
+private:
+  std::vector<Task::Handle> running;
+
+  void forget(Task::Handle h) {
+    for (size_t i = 0; i < running.size(); i++) {
+      if (running[i] == h) {
+        running[i] = running.back();
+        running.pop_back();
+        return;
+      }
+    }
+  }
+  friend struct Task::promise_type;
+};
+
+inline Task::promise_type::~promise_type() {
+  if (scope != nullptr) scope->forget(Handle::from_promise(*this));
+}
+
+#endif // _TASK_H_
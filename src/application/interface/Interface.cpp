@@ -8,6 +8,7 @@
 
 #include "application/interface/Toast.h"
 #include "events/types/TouchEvent.h"
+#include "util/RenderProfiler.h"
 
 Interface::Interface(Application *app) {
   this->app = app;
@@ -17,12 +18,14 @@ Interface::Interface(Application *app) {
 // this automatically deletes the components contained within
 Interface::~Interface() { delete manager; }
 
-void Interface::loop() {
+uint32_t Interface::loop() {
   if (refresh) {
+    ProfileScope scope(ProfileStage::Rebuild);
     manager->createComponent(app->workflow().getState());
     refresh = false;
   }
-  lv_timer_handler();
+  ProfileScope scope(ProfileStage::Timers);
+  return lv_timer_handler();
 }
 
 void Interface::handleEvent(InputEvent &event) {
@@ -30,6 +33,12 @@ void Interface::handleEvent(InputEvent &event) {
   // (toast was visible), suppress component input so swipe/tap rules
   // don't fire underneath it.
   if (Toast::handleEvent(event)) return;
+  // a contact LVGL turned into a scroll is not also a tap
+  if (event.inputType == InputType::TouchInput &&
+      static_cast<TouchEvent &>(event).type == TouchType::TapType &&
+      app->device()->touchscreen().isScrolling()) {
+    return;
+  }
   // manager needs to dispatch this event to the active components
   manager->handleEvent(event);
 }
@@ -20,7 +20,9 @@ public:
   Interface(Application *app);
   ~Interface();
 
-  void loop();
+  // Rebuild if needed and run LVGL timers; returns ms until the next
+  // LVGL timer is due (LV_NO_TIMER_READY if none)
+  uint32_t loop();
   void handleEvent(InputEvent &event);
   void handleEvent(WorkflowEvent &event);
 };
@@ -2,24 +2,55 @@
 
 #include "application/interface/components/ComponentManager.h"
 #include "config/screens/Routes.h"
+#include "events/types/TouchEvent.h"
+#include "util/AllocTracker.h"
+#include "util/LatencyTracer.h"
 
 void ComponentManager::createComponent(State state) {
+  // keep the outgoing screen on the display until its replacement is loaded
+  lv_obj_t *oldScreen = screen;
+  // drop tap targets while their objects still exist
+  hitIndex.clear();
   // if we are already assigned to a component, destroy it first
   if (active != nullptr) {
     deleteComponent();
   }
+#ifdef ALLOC_TRACKER
+  AllocTracker::beginTransition();
+#endif
 
   // create a new LVGL screen
   screen = lv_obj_create(NULL);
   lv_obj_remove_style_all(screen);
 
   // create the component tree from the declarative DSL
-  active = createComponentFromState(state, app);
-  active->attachApplication(app);
-  // build the LVGL widget tree on the screen
-  active->createWidgets(screen);
-  // load the screen (with no animation for now)
-  lv_screen_load(screen);
+  {
+    AllocScope scope(AllocPhase::ComponentBuild);
+    active = createComponentFromState(state, app);
+    active->attachApplication(app);
+  }
+  {
+    AllocScope scope(AllocPhase::WidgetCreate);
+    // build the LVGL widget tree on the screen
+    active->createWidgets(screen);
+    // load the screen (with no animation for now)
+    lv_screen_load(screen);
+  }
+  active->registerHitTargets(hitIndex);
+  // LVGL does not free a screen when another is loaded
+  if (oldScreen != nullptr) {
+#ifdef ALLOC_TRACKER
+    AllocTracker::beginTeardown();
+#endif
+    lv_obj_delete(oldScreen);
+#ifdef ALLOC_TRACKER
+    AllocTracker::endTeardown();
+#endif
+  }
+  LatencyTracer::markActive(LatencyStage::Rebuild);
+#ifdef ALLOC_TRACKER
+  AllocTracker::endTransition((int)state);
+#endif
 }
 
 void ComponentManager::deleteComponent() {
@@ -27,12 +58,22 @@ void ComponentManager::deleteComponent() {
     delete active;
     active = nullptr;
   }
-  // the old screen will be cleaned up by LVGL when replaced
+  // createComponent deletes the old screen once the new one is loaded
   screen = nullptr;
 }
 
 void ComponentManager::handleEvent(InputEvent &event) {
-  if (active != nullptr) {
-    active->handleEvent(event);
+  if (event.inputType == InputType::TouchInput) {
+    LatencyTracer::mark(static_cast<TouchEvent &>(event).traceId,
+                        LatencyStage::Dispatch);
+  }
+  if (active == nullptr) return;
+  // taps go only to the components under them; swipes are broadcast
+  if (event.inputType == InputType::TouchInput &&
+      static_cast<TouchEvent &>(event).type == TouchType::TapType) {
+    auto &tap = static_cast<TapTouchEvent &>(event);
+    hitIndex.dispatch(event, tap.location.x, tap.location.y);
+    return;
   }
+  active->handleEvent(event);
 }
@@ -7,6 +7,7 @@ class Component;
 
 #include "lvgl.h"
 
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/Component.h"
 #include "application/workflow/Workflow.h"
 #include "events/EventHandler.h"
@@ -17,6 +18,8 @@ private:
   Application *app;
   Component *active = nullptr;
   lv_obj_t *screen = nullptr;
+  // tap targets of the active component tree
+  HitTestIndex hitIndex;
 
 public:
   ComponentManager(Application *app) : app(app) {};
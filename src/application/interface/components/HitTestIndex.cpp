@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include "application/interface/components/HitTestIndex.h"
+#include "application/interface/components/types/Component.h"
+
+void HitTestIndex::clear() {
+  for (lv_obj_t *obj : watched) {
+    lv_obj_remove_event_cb_with_user_data(obj, onGeometryChanged, this);
+  }
+  watched.clear();
+  screen = nullptr;
+  entries.clear();
+  globals.clear();
+  cells.clear();
+  cols = rows = 0;
+  dirty = true;
+}
+
+// Scrolling or re-layout of the target or any ancestor moves its area
+void HitTestIndex::watch(lv_obj_t *obj) {
+  for (; obj != nullptr; obj = lv_obj_get_parent(obj)) {
+    if (std::find(watched.begin(), watched.end(), obj) != watched.end()) return;
+    watched.push_back(obj);
+    lv_obj_add_event_cb(obj, onGeometryChanged, LV_EVENT_SIZE_CHANGED, this);
+    lv_obj_add_event_cb(obj, onGeometryChanged, LV_EVENT_LAYOUT_CHANGED, this);
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_SCROLLABLE)) {
+      lv_obj_add_event_cb(obj, onGeometryChanged, LV_EVENT_SCROLL, this);
+    }
+  }
+}
+
+void HitTestIndex::addTarget(Component *component, lv_obj_t *obj) {
+  if (obj == nullptr) return;
+  entries.push_back({component, obj, {}});
+  screen = lv_obj_get_screen(obj);
+  watch(obj);
+  dirty = true;
+}
+
+void HitTestIndex::addGlobal(Component *component) {
+  globals.push_back((uint16_t)entries.size());
+  entries.push_back({component, nullptr, {}});
+}
+
+void HitTestIndex::onGeometryChanged(lv_event_t *e) {
+  static_cast<HitTestIndex *>(lv_event_get_user_data(e))->markDirty();
+}
+
+void HitTestIndex::rebuild() {
+  if (screen != nullptr) lv_obj_update_layout(screen);
+  // the layout pass above reports its own changes; they are already applied
+  dirty = false;
+
+  int w = lv_display_get_horizontal_resolution(NULL);
+  int h = lv_display_get_vertical_resolution(NULL);
+  cols = (w + HIT_TEST_CELL_SIZE - 1) / HIT_TEST_CELL_SIZE;
+  rows = (h + HIT_TEST_CELL_SIZE - 1) / HIT_TEST_CELL_SIZE;
+  cells.assign(cols * rows, {});
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    Entry &entry = entries[i];
+    if (entry.obj == nullptr) continue;
+    lv_obj_get_coords(entry.obj, &entry.area);
+    int c1 = std::max(0, (int)entry.area.x1 / HIT_TEST_CELL_SIZE);
+    int c2 = std::min(cols - 1, (int)entry.area.x2 / HIT_TEST_CELL_SIZE);
+    int r1 = std::max(0, (int)entry.area.y1 / HIT_TEST_CELL_SIZE);
+    int r2 = std::min(rows - 1, (int)entry.area.y2 / HIT_TEST_CELL_SIZE);
+    for (int r = r1; r <= r2; r++) {
+      for (int c = c1; c <= c2; c++) cells[r * cols + c].push_back((uint16_t)i);
+    }
+  }
+}
+
+size_t HitTestIndex::dispatch(InputEvent &event, int x, int y) {
+  if (entries.empty()) return 0;
+  if (dirty) rebuild();
+
+  static const std::vector<uint16_t> none;
+  const std::vector<uint16_t> *cell = &none;
+  if (x >= 0 && y >= 0 && x / HIT_TEST_CELL_SIZE < cols && y / HIT_TEST_CELL_SIZE < rows) {
+    cell = &cells[(y / HIT_TEST_CELL_SIZE) * cols + x / HIT_TEST_CELL_SIZE];
+  }
+
+  // merge the two ascending index lists to keep tree order
+  size_t delivered = 0;
+  size_t g = 0, t = 0;
+  while (g < globals.size() || t < cell->size()) {
+    uint16_t i;
+    if (t >= cell->size() || (g < globals.size() && globals[g] < (*cell)[t])) {
+      i = globals[g++];
+    } else {
+      i = (*cell)[t++];
+      const lv_area_t &a = entries[i].area;
+      if (x < a.x1 || x > a.x2 || y < a.y1 || y > a.y2) continue;
+    }
+    entries[i].component->handleEvent(event);
+    delivered++;
+  }
+  return delivered;
+}
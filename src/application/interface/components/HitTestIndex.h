@@ -0,0 +1,59 @@
+#ifndef _HIT_TEST_INDEX_H_
+#define _HIT_TEST_INDEX_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "lvgl.h"
+
+#include "events/types/InputEvent.h"
+
+// forward declaration to avoid circular references
+struct Component;
+
+// Grid cell edge in pixels
+#define HIT_TEST_CELL_SIZE 32
+
+// Uniform-grid index of the interactive regions on the active screen, so a
+// tap is delivered only to the components under it instead of being
+// broadcast through the whole tree.
+//
+// Components opt in from registerHitTargets(): addTarget() for anything
+// that hit-tests its own lvObj, addGlobal() for handlers that need every
+// tap (e.g. TouchNavigation's region rules). Areas are read lazily on the
+// next tap after the screen is built, scrolled or re-laid out.
+class HitTestIndex {
+private:
+  struct Entry {
+    Component *component;
+    lv_obj_t *obj; // nullptr for globals
+    lv_area_t area;
+  };
+
+  std::vector<Entry> entries;           // registration (tree) order
+  std::vector<uint16_t> globals;        // entry indices
+  std::vector<std::vector<uint16_t>> cells;
+  std::vector<lv_obj_t *> watched;      // objects carrying our event callbacks
+  lv_obj_t *screen = nullptr;
+  int cols = 0, rows = 0;
+  bool dirty = true;
+
+  void watch(lv_obj_t *obj);
+  void rebuild();
+  static void onGeometryChanged(lv_event_t *e);
+
+public:
+  // Forget all targets (call before the old screen's objects are deleted)
+  void clear();
+  void addTarget(Component *component, lv_obj_t *obj);
+  void addGlobal(Component *component);
+  void markDirty() { dirty = true; }
+
+  // Deliver a tap at (x, y) to the globals and the targets containing it,
+  // in tree order. Returns how many components received the event.
+  size_t dispatch(InputEvent &event, int x, int y);
+
+  size_t size() const { return entries.size(); }
+};
+
+#endif // _HIT_TEST_INDEX_H_
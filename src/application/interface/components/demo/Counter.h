@@ -1,6 +1,7 @@
 #ifndef _COUNTER_COMPONENT_H_
 #define _COUNTER_COMPONENT_H_
 
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/StatefulComponent.h"
 #include "events/types/TouchEvent.h"
 
@@ -22,6 +23,11 @@ public:
     lv_label_set_text(label, buf);
   }
 
+  // counts taps anywhere on the screen
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addGlobal(this);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (event.inputType != InputType::TouchInput) return;
     TouchEvent &te = static_cast<TouchEvent &>(event);
@@ -6,13 +6,9 @@
 
 #include "application/Application.h"
 #include "application/interface/components/types/StatefulComponent.h"
+#include "application/async/Async.h"
 #include "config/NetworkConfig.h"
-
-#ifndef BOARD_SIMULATOR
-#include <freertos/FreeRTOS.h>
-#include <freertos/task.h>
-#include <freertos/semphr.h>
-#endif
+#include "util/JsonAllocator.h"
 
 // Base class for components that fetch text content from the server.
 // DynamicText and LLMText derive from this, differing only in their API path.
@@ -20,8 +16,9 @@
 // The content_key is computed server-side and injected into the manifest JSON
 // when saving. The device reads it directly — no client-side hashing needed.
 //
-// On ESP32 hardware: network fetches run in a FreeRTOS background task.
-// On simulator: fetches run synchronously in the LVGL timer callback.
+// poll() is a Task: the request is queued at background priority and
+// parsed on the network thread, the label is updated on the UI loop, and
+// destroying the component cancels it wherever it waits.
 class ServerTextBase : public StatefulComponent {
 protected:
   String contentKey;
@@ -34,30 +31,67 @@ protected:
   bool loading = true;
 
   lv_obj_t *textLabel = nullptr;
-  lv_timer_t *pollTimer = nullptr;
+  TaskScope tasks;
 
   virtual const char *apiPath() = 0;
 
-  void fetchContent() {
-    if (app == nullptr) return;
-    INetwork &net = app->device()->network();
-    if (!net.isConnected()) {
-      if (loading) {
+  // What a fetch produced, built by parse() on the network thread
+  struct FetchResult {
+    int statusCode = -1;
+    String text;
+    String etag;
+  };
+
+  // Runs on the network thread: only touches its argument
+  static FetchResult parse(HttpResponse &resp) {
+    FetchResult result;
+    result.statusCode = resp.statusCode;
+    if (resp.statusCode != 200) return result;
+
+    // Parse JSON response: {"text": "...", "etag": "..."}
+    JsonDocument doc(jsonAllocator());
+    DeserializationError err = deserializeJson(doc, resp.body.c_str(), resp.body.size());
+    if (!err) {
+      result.text = String(doc["text"].as<const char *>());
+      if (doc["etag"]) {
+        result.etag = String("\"") + String(doc["etag"].as<const char *>()) + "\"";
+      }
+    } else {
+      result.text = "[parse error]";
+    }
+    return result;
+  }
+
+  // Initial fetch once the screen has rendered, then one every ttlSeconds
+  // after the previous one lands
+  Task poll() {
+    co_await Async::sleep(100);
+    for (;;) {
+      if (app == nullptr) co_return;
+      INetwork *net = &app->device()->network();
+      if (net->isConnected()) {
+        char url[256];
+        snprintf(url, sizeof(url), "%s%s?key=%s",
+                 OTA_UPDATE_URL, apiPath(), contentKey.c_str());
+        HttpRequest req;
+        req.url = url;
+        req.ifNoneMatch = etag;
+        req.priority = RequestPriority::Background;
+        FetchResult result =
+            co_await NetworkCall<FetchResult>(net, std::move(req), parse);
+        applyResult(result);
+      } else if (loading) {
         currentText = "No network";
         loading = false;
         update();
       }
-      return;
+      if (ttlSeconds <= 0) co_return;
+      co_await Async::sleep(ttlSeconds * 1000);
     }
+  }
 
-    char url[256];
-    snprintf(url, sizeof(url), "%s%s?key=%s",
-             OTA_UPDATE_URL, apiPath(), contentKey.c_str());
-
-    const char *etagPtr = etag.length() > 0 ? etag.c_str() : nullptr;
-    HttpResponse resp = net.get(url, nullptr, etagPtr);
-
-    if (resp.statusCode == 304) {
+  void applyResult(FetchResult &result) {
+    if (result.statusCode == 304) {
       // Content unchanged
       if (loading) {
         loading = false;
@@ -66,26 +100,17 @@ protected:
       return;
     }
 
-    if (resp.statusCode == 200) {
-      // Parse JSON response: {"text": "...", "etag": "..."}
-      JsonDocument doc;
-      DeserializationError err = deserializeJson(doc, resp.body);
-      if (!err) {
-        currentText = String(doc["text"].as<const char *>());
-        if (doc["etag"]) {
-          etag = String("\"") + String(doc["etag"].as<const char *>()) + "\"";
-        }
-      } else {
-        currentText = "[parse error]";
-      }
+    if (result.statusCode == 200) {
+      currentText = result.text;
+      if (result.etag.length() > 0) etag = result.etag;
       loading = false;
       update();
       return;
     }
 
-    if (resp.statusCode > 0) {
+    if (result.statusCode > 0) {
       Serial.printf("[ServerText] HTTP %d for key=%s\n",
-                    resp.statusCode, contentKey.c_str());
+                    result.statusCode, contentKey.c_str());
     }
     if (loading) {
       currentText = "Error";
@@ -94,58 +119,6 @@ protected:
     }
   }
 
-#ifndef BOARD_SIMULATOR
-  // --- FreeRTOS background fetch ---
-  struct FetchContext {
-    ServerTextBase *self;
-    bool done = false;
-    SemaphoreHandle_t mutex;
-  };
-
-  FetchContext *_fetchCtx = nullptr;
-
-  static void fetchTask(void *param) {
-    FetchContext *ctx = static_cast<FetchContext *>(param);
-    ctx->self->fetchContent();
-    xSemaphoreTake(ctx->mutex, portMAX_DELAY);
-    ctx->done = true;
-    xSemaphoreGive(ctx->mutex);
-    vTaskDelete(nullptr);
-  }
-
-  void startBackgroundFetch() {
-    if (_fetchCtx != nullptr) {
-      // Check if previous fetch is still running
-      xSemaphoreTake(_fetchCtx->mutex, portMAX_DELAY);
-      bool done = _fetchCtx->done;
-      xSemaphoreGive(_fetchCtx->mutex);
-      if (!done) return;  // Still running, skip
-      vSemaphoreDelete(_fetchCtx->mutex);
-      delete _fetchCtx;
-    }
-    _fetchCtx = new FetchContext{this, false, xSemaphoreCreateMutex()};
-    xTaskCreate(fetchTask, "srvtxt", 8192, _fetchCtx, 1, nullptr);
-  }
-#endif
-
-  static void pollTimerCb(lv_timer_t *timer) {
-    auto *self = static_cast<ServerTextBase *>(lv_timer_get_user_data(timer));
-#ifdef BOARD_SIMULATOR
-    self->fetchContent();
-#else
-    self->startBackgroundFetch();
-#endif
-  }
-
-  static void deferredFetchCb(lv_timer_t *timer) {
-    auto *self = static_cast<ServerTextBase *>(lv_timer_get_user_data(timer));
-#ifdef BOARD_SIMULATOR
-    self->fetchContent();
-#else
-    self->startBackgroundFetch();
-#endif
-  }
-
   static const lv_font_t *fontForSize(uint8_t size) {
     switch (size) {
       case 1: return &lv_font_montserrat_10;
@@ -162,18 +135,6 @@ public:
       : contentKey(contentKey), ttlSeconds(ttl), fontSize(size),
         fontColor(color) {}
 
-  virtual ~ServerTextBase() {
-#ifndef BOARD_SIMULATOR
-    if (_fetchCtx) {
-      vSemaphoreDelete(_fetchCtx->mutex);
-      delete _fetchCtx;
-    }
-#endif
-    if (pollTimer) {
-      lv_timer_delete(pollTimer);
-    }
-  }
-
   void createWidgets(lv_obj_t *parent) override {
     lvObj = lv_obj_create(parent);
     lv_obj_remove_style_all(lvObj);
@@ -190,14 +151,7 @@ public:
     loading = true;
     update();
 
-    // Deferred initial fetch
-    lv_timer_t *t = lv_timer_create(deferredFetchCb, 100, this);
-    lv_timer_set_repeat_count(t, 1);
-
-    // Repeating poll timer
-    if (ttlSeconds > 0) {
-      pollTimer = lv_timer_create(pollTimerCb, ttlSeconds * 1000, this);
-    }
+    tasks.spawn(poll());
   }
 
   void update() override {
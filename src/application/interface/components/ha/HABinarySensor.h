@@ -3,6 +3,7 @@
 
 #include "application/Application.h"
 #include "application/interface/components/types/StatefulComponent.h"
+#include "application/async/Async.h"
 #include "application/services/HomeAssistant.h"
 
 // Displays a binary sensor (e.g. presence) with a friendly label.
@@ -15,6 +16,8 @@ class HABinarySensor : public StatefulComponent {
 
   lv_obj_t *nameLabel = nullptr;
   lv_obj_t *stateLabel = nullptr;
+  TaskScope tasks;
+  EntityStore::Subscription watch;
 
 public:
   HABinarySensor(const char *entityId, const char *label)
@@ -37,11 +40,13 @@ public:
     stateLabel = lv_label_create(lvObj);
     lv_obj_set_style_text_font(stateLabel, &lv_font_montserrat_12, 0);
 
-    loading = true;
+    HomeAssistant *ha = app ? app->ha() : nullptr;
+    EntitySnapshot cached;
+    loading = !(ha && ha->cached(entityId, cached));
+    if (!loading) entityState = cached.state();
     update();
 
-    lv_timer_t *t = lv_timer_create(deferredFetchCb, 100, this);
-    lv_timer_set_repeat_count(t, 1);
+    tasks.spawn(load(!loading));
   }
 
   void update() override {
@@ -59,21 +64,19 @@ public:
   }
 
 private:
-  static void deferredFetchCb(lv_timer_t *timer) {
-    auto *self = static_cast<HABinarySensor *>(lv_timer_get_user_data(timer));
-    self->refreshState();
-  }
-
-  void refreshState() {
-    if (app == nullptr) return;
+  Task load(bool cached) {
+    if (!cached) co_await Async::sleep(100);
+    if (app == nullptr) co_return;
     HomeAssistant *ha = app->ha();
-    if (ha == nullptr) {
-      loading = false;
+    if (ha != nullptr) {
+      watch = ha->entities().subscribe(entityId, [this](const EntitySnapshot &e) {
+        entityState = e.state();
+        update();
+      });
+      entityState = co_await ha->state(entityId);
+    } else {
       entityState = "unavailable";
-      update();
-      return;
     }
-    entityState = ha->getEntityState(entityId);
     loading = false;
     update();
   }
@@ -2,18 +2,35 @@
 #define _HA_TOGGLE_COMPONENT_H_
 
 #include "application/Application.h"
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/StatefulComponent.h"
 #include "application/interface/components/input/Button.h"
+#include "application/async/Async.h"
 #include "application/services/HomeAssistant.h"
 #include "events/types/TouchEvent.h"
 
+// How long a failed toggle shows its warning
+#define HA_TOGGLE_ERROR_MS 2000
+
+// Optimistic: a tap flips the display at once and the service call runs on
+// the service worker. Taps made while a call is out collapse into one
+// follow-up call for the last one; when the calls settle, the display
+// takes whatever state HA reports. A failed call rolls back to that state
+// with a warning.
 class HAToggle : public StatefulComponent {
   const char *entityId;
-  String entityState = "unknown";
+  String entityState = "unknown"; // last state HA reported
   bool loading = true;
+  bool commanding = false; // calls in flight; showing desiredOn
+  bool desiredOn = false;
+  bool failed = false;
   lv_obj_t *nameLabel = nullptr;
   lv_obj_t *stateLabel = nullptr;
-  Timer debounce{300};
+  Timer debounce{200};
+  // cancelled with the component, mid-request or not
+  TaskScope tasks;
+  // background refreshes of a cached state, and changes made elsewhere
+  EntityStore::Subscription watch;
 
 public:
   HAToggle(const char *entityId) : entityId(entityId) {};
@@ -33,13 +50,15 @@ public:
 
     stateLabel = lv_label_create(lvObj);
 
-    // Show loading state; defer the blocking HTTP fetch so
-    // createWidgets() returns immediately and the screen renders first.
-    loading = true;
+    // A state already in the store renders with the screen; otherwise show
+    // loading and defer the fetch so the screen renders first.
+    HomeAssistant *ha = app ? app->ha() : nullptr;
+    EntitySnapshot cached;
+    loading = !(ha && ha->cached(entityId, cached));
+    if (!loading) entityState = cached.state();
     update();
 
-    lv_timer_t *t = lv_timer_create(deferredFetchCb, 50, this);
-    lv_timer_set_repeat_count(t, 1);
+    tasks.spawn(load(!loading));
   }
 
   void update() override {
@@ -49,10 +68,21 @@ public:
       lv_obj_set_style_text_color(stateLabel, lv_color_hex(0x71717A), 0); // zinc-500
       return;
     }
-    bool isOn = entityState == "on";
+    bool isOn = displayedOn();
+    if (failed) {
+      lv_label_set_text(stateLabel, isOn ? LV_SYMBOL_WARNING " ON" : LV_SYMBOL_WARNING " OFF");
+      lv_obj_set_style_text_color(stateLabel, lv_color_hex(0xF59E0B), 0); // amber-500
+      return;
+    }
     lv_label_set_text(stateLabel, isOn ? LV_SYMBOL_OK " ON" : LV_SYMBOL_CLOSE " OFF");
-    lv_obj_set_style_text_color(stateLabel,
-                                lv_color_hex(isOn ? 0x22C55E : 0xEF4444), 0);
+    uint32_t color = isOn ? 0x22C55E : 0xEF4444;
+    // paler until HA confirms
+    if (commanding) color = isOn ? 0x86EFAC : 0xFCA5A5; // green-300 / red-300
+    lv_obj_set_style_text_color(stateLabel, lv_color_hex(color), 0);
+  }
+
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
   }
 
   void handleEvent(InputEvent &event) override {
@@ -63,38 +93,62 @@ public:
 
     TapTouchEvent &tap = static_cast<TapTouchEvent &>(event);
     if (!Button::hitTest(lvObj, tap.location.x, tap.location.y)) return;
-    if (debounce.running()) return;
+    if (loading || debounce.running()) return;
     debounce.start();
 
-    if (app == nullptr) return;
-    HomeAssistant *ha = app->ha();
-    if (ha == nullptr) return;
-
-    loading = true;
+    if (app == nullptr || app->ha() == nullptr) return;
+    desiredOn = !displayedOn();
+    failed = false;
+    bool idle = !commanding;
+    commanding = true;
     update();
-    lv_timer_handler();
-
-    ha->toggle(entityId);
-    refreshState();
+    // a running command picks up the new desiredOn when its call returns
+    if (idle) tasks.spawn(command());
   }
 
 private:
-  static void deferredFetchCb(lv_timer_t *timer) {
-    auto *self = static_cast<HAToggle *>(lv_timer_get_user_data(timer));
-    self->refreshState();
+  // revalidates a cached state, which is already on screen
+  Task load(bool cached) {
+    if (!cached) co_await Async::sleep(50);
+    if (app == nullptr) co_return;
+    HomeAssistant *ha = app->ha();
+    if (ha == nullptr) {
+      showState("unavailable");
+      co_return;
+    }
+    watch = ha->entities().subscribe(
+        entityId, [this](const EntitySnapshot &e) { showState(e.state()); });
+    showState(co_await ha->state(entityId));
   }
 
-  void refreshState() {
-    if (app == nullptr) return;
+  Task command() {
     HomeAssistant *ha = app->ha();
-    if (ha == nullptr) {
-      loading = false;
-      entityState = "unavailable";
+    for (;;) {
+      bool target = desiredOn;
+      CommandResult result = co_await ha->switchTo(entityId, target);
+      if (result.entity.ok()) entityState = result.entity.state();
+      if (!result.ok) {
+        failed = true;
+        break;
+      }
+      if (desiredOn == target) break;
+      // tapped again while the call was out: send the latest
+    }
+    commanding = false;
+    update();
+    if (failed) {
+      co_await Async::sleep(HA_TOGGLE_ERROR_MS);
+      failed = false;
       update();
-      return;
     }
+  }
+
+  bool displayedOn() const {
+    return commanding ? desiredOn : entityState == "on";
+  }
 
-    entityState = ha->getEntityState(entityId);
+  void showState(const String &state) {
+    entityState = state;
     loading = false;
     update();
   }
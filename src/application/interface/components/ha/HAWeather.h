@@ -3,6 +3,7 @@
 
 #include "application/Application.h"
 #include "application/interface/components/types/StatefulComponent.h"
+#include "application/async/Async.h"
 #include "application/services/HomeAssistant.h"
 
 // Displays weather condition, temperature, and humidity from a HA weather entity.
@@ -17,6 +18,8 @@ class HAWeather : public StatefulComponent {
   lv_obj_t *condLabel = nullptr;
   lv_obj_t *tempLabel = nullptr;
   lv_obj_t *humLabel = nullptr;
+  TaskScope tasks;
+  EntityStore::Subscription watch;
 
   // Map weather condition to an LVGL symbol
   static const char *conditionIcon(const String &cond) {
@@ -55,11 +58,17 @@ public:
     lv_obj_set_style_text_font(humLabel, &lv_font_montserrat_12, 0);
     lv_obj_set_style_text_color(humLabel, lv_color_hex(0xA1A1AA), 0);
 
-    loading = true;
-    update();
+    HomeAssistant *ha = app ? app->ha() : nullptr;
+    EntitySnapshot cached;
+    bool hit = ha && ha->cached(entityId, cached);
+    if (hit) {
+      show(cached);
+    } else {
+      loading = true;
+      update();
+    }
 
-    lv_timer_t *t = lv_timer_create(deferredFetchCb, 100, this);
-    lv_timer_set_repeat_count(t, 1);
+    tasks.spawn(load(hit));
   }
 
   void update() override {
@@ -83,25 +92,28 @@ public:
   }
 
 private:
-  static void deferredFetchCb(lv_timer_t *timer) {
-    auto *self = static_cast<HAWeather *>(lv_timer_get_user_data(timer));
-    self->refreshState();
-  }
-
-  void refreshState() {
-    if (app == nullptr) return;
+  Task load(bool cached) {
+    if (!cached) co_await Async::sleep(100);
+    if (app == nullptr) co_return;
     HomeAssistant *ha = app->ha();
     if (ha == nullptr) {
       loading = false;
       condition = "unavailable";
       update();
-      return;
+      co_return;
     }
 
-    condition = ha->getEntityState(entityId);
-    temperature = ha->getEntityAttribute(entityId, "temperature");
-    tempUnit = ha->getEntityAttribute(entityId, "temperature_unit");
-    humidity = ha->getEntityAttribute(entityId, "humidity");
+    watch = ha->entities().subscribe(
+        entityId, [this](const EntitySnapshot &e) { show(e); });
+    // one request for all four fields
+    show(co_await ha->entity(entityId));
+  }
+
+  void show(const EntitySnapshot &weather) {
+    condition = weather.state();
+    temperature = weather.attribute("temperature");
+    tempUnit = weather.attribute("temperature_unit");
+    humidity = weather.attribute("humidity");
     loading = false;
     update();
   }
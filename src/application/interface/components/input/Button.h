@@ -1,6 +1,7 @@
 #ifndef _BUTTON_COMPONENT_H_
 #define _BUTTON_COMPONENT_H_
 
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/Component.h"
 #include "events/types/TouchEvent.h"
 #include "util/Timer.h"
@@ -48,6 +49,10 @@ public:
     lv_obj_set_style_text_color(txt, lv_color_hex(props.color), 0);
   }
 
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (lvObj == nullptr) return;
     if (event.inputType != InputType::TouchInput) return;
@@ -2,12 +2,8 @@
 #define _SCROLL_CONTAINER_H_
 
 #include "application/Application.h"
+#include "application/interface/components/input/TouchNavigation.h"
 #include "application/interface/components/types/ComponentWithChildren.h"
-#include "events/types/TouchEvent.h"
-
-// Scroll step scales with screen height — small on 240px, large on 480px
-#define SCROLL_STEP_SMALL 80
-#define SCROLL_STEP_LARGE 200
 
 struct ScrollContainerProps {
   int pad = 16;
@@ -19,6 +15,19 @@ class ScrollContainer : public ComponentWithChildren {
 private:
   ScrollContainerProps props;
 
+  // A drag from the top/bottom edge zone is TouchNavigation's (the shade):
+  // drop it instead of scrolling, or the list would move and then navigate.
+  // LVGL starts a scroll within its scroll limit (a few px) of the press,
+  // so the current point stands in for where the contact began.
+  static void onScrollBegin(lv_event_t *e) {
+    lv_indev_t *indev = lv_indev_active();
+    if (indev == nullptr) return; // scrolled by code, not a finger
+    lv_point_t p;
+    lv_indev_get_point(indev, &p);
+    int height = (int)(intptr_t)lv_event_get_user_data(e);
+    if (TouchNavigation::inEdgeZone(p.y, height)) lv_indev_wait_release(indev);
+  }
+
 public:
   template <typename... T>
   ScrollContainer(ScrollContainerProps props, T *...children)
@@ -60,59 +69,21 @@ public:
     lv_obj_set_style_pad_bottom(lvObj, padV, 0);
     lv_obj_set_style_pad_row(lvObj, props.gap, 0);
 
+    // scrolling is LVGL's own: it follows the touchscreen pointer, with
+    // momentum and elastic edges
     lv_obj_add_flag(lvObj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(lvObj, LV_DIR_VER);
     lv_obj_set_scrollbar_mode(lvObj, LV_SCROLLBAR_MODE_OFF);
+    if (app != nullptr) {
+      int h = app->device()->display().height();
+      lv_obj_add_event_cb(lvObj, onScrollBegin, LV_EVENT_SCROLL_BEGIN,
+                          (void *)(intptr_t)h);
+    }
 
     for (auto &child : children) {
       child->createWidgets(lvObj);
     }
   }
-
-  void handleEvent(InputEvent &event) override {
-    // Forward to children first
-    ComponentWithChildren::handleEvent(event);
-
-    if (lvObj == nullptr) return;
-    if (event.inputType != InputType::TouchInput) return;
-    auto &te = static_cast<TouchEvent &>(event);
-    if (te.type != TouchType::SwipeType) return;
-
-    auto &se = static_cast<SwipeTouchEvent &>(event);
-    bool isVertical = se.direction == SwipeDirection::SwipeUp ||
-                      se.direction == SwipeDirection::SwipeDown;
-    if (!isVertical) return;
-
-    // Only scroll for non-edge swipes — edge swipes are reserved for
-    // screen navigation (handled by TouchNavigation)
-    int h = lv_obj_get_height(lvObj);
-    int edgeZone = h * 15 / 100;
-    int y = se.startLocation.y;
-    bool fromEdge = (y < edgeZone) || (y > h - edgeZone);
-    if (fromEdge) return;
-
-    // Clamp: don't scroll past top or bottom
-    int scrollY = lv_obj_get_scroll_y(lvObj);
-    int scrollBottom = lv_obj_get_scroll_bottom(lvObj);
-
-    // Scale scroll step and animation to screen size
-    bool isLarge = h > 300;
-    int step = isLarge ? SCROLL_STEP_LARGE : SCROLL_STEP_SMALL;
-    lv_anim_enable_t anim = isLarge ? LV_ANIM_OFF : LV_ANIM_ON;
-
-    if (se.direction == SwipeDirection::SwipeUp) {
-      // Swipe up = scroll content down (reveal more below)
-      if (scrollBottom <= 0) return; // already at bottom
-      int dy = -step;
-      if (-dy > scrollBottom) dy = -scrollBottom;
-      lv_obj_scroll_by(lvObj, 0, dy, anim);
-    } else {
-      // Swipe down = scroll content up (reveal more above)
-      if (scrollY <= 0) return; // already at top
-      int dy = step;
-      if (dy > scrollY) dy = scrollY;
-      lv_obj_scroll_by(lvObj, 0, dy, anim);
-    }
-  }
 };
 
 #endif // _SCROLL_CONTAINER_H_
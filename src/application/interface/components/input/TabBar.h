@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "application/Application.h"
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/input/Button.h"
 #include "application/interface/components/types/Component.h"
 #include "events/types/TouchEvent.h"
@@ -98,6 +99,10 @@ public:
     }
   }
 
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (lvObj == nullptr) return;
     if (app == nullptr) return;
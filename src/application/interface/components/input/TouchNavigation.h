@@ -5,20 +5,35 @@
 #include <vector>
 
 #include "application/Application.h"
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/input/StateChangeRule.h"
 #include "application/interface/components/types/Component.h"
 #include "events/types/TouchEvent.h"
 
+// Vertical swipes starting this close to the top or bottom edge are
+// system gestures (navigation), not scrolls
+#define TOUCH_NAV_EDGE_ZONE_PCT 15
+
 class TouchNavigation : public Component {
   std::vector<StateChangeRule> rules;
 
 public:
+  static bool inEdgeZone(int y, int screenHeight) {
+    int edgeZone = screenHeight * TOUCH_NAV_EDGE_ZONE_PCT / 100;
+    return y < edgeZone || y > screenHeight - edgeZone;
+  }
+
   TouchNavigation(StateChangeRule rule) : rules{rule} {};
   TouchNavigation(std::initializer_list<StateChangeRule> rules)
       : rules(rules) {};
   TouchNavigation(std::vector<StateChangeRule> rules)
       : rules(std::move(rules)) {};
 
+  // tap rules carry their own regions, so see every tap
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addGlobal(this);
+  }
+
   void handleEvent(InputEvent &event) {
     if (event.inputType != InputType::TouchInput) {
       return;
@@ -32,17 +47,14 @@ public:
       if (tevent.type == TouchType::SwipeType) {
         SwipeTouchEvent &sevent = static_cast<SwipeTouchEvent &>(event);
         if (sevent.direction != rule.direction) continue;
-        // Vertical swipes only navigate when started from edge zones
-        // (top/bottom 15% of screen), like iOS/Android system gestures.
-        // This lets interior swipes scroll content instead.
+        // Vertical swipes only navigate when started from edge zones,
+        // like iOS/Android system gestures. This lets interior swipes
+        // scroll content instead (and ScrollContainer leaves edge ones).
         bool isVertical = sevent.direction == SwipeDirection::SwipeUp ||
                           sevent.direction == SwipeDirection::SwipeDown;
         if (isVertical && app != nullptr) {
-          int h = app->device()->display().height();
-          int edgeZone = h * 15 / 100;
-          int y = sevent.startLocation.y;
-          bool fromEdge = (y < edgeZone) || (y > h - edgeZone);
-          navigate = fromEdge;
+          navigate = inEdgeZone(sevent.startLocation.y,
+                                app->device()->display().height());
         } else {
           navigate = true;
         }
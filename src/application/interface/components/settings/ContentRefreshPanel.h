@@ -2,8 +2,10 @@
 #define _CONTENT_REFRESH_PANEL_H_
 
 #include "application/Application.h"
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/StatefulComponent.h"
 #include "application/interface/components/input/Button.h"
+#include "application/services/ServiceExecutor.h"
 #include "config/NetworkConfig.h"
 #include "events/types/TouchEvent.h"
 
@@ -15,34 +17,55 @@ class ContentRefreshPanel : public StatefulComponent {
   lv_obj_t *statusLabel = nullptr;
   lv_obj_t *actionLabel = nullptr;
 
+  Lifetime lifetime;
+
+  struct RefreshResult {
+    int refreshStatus = -1;
+    int manifestStatus = -1;
+    ResponseBuffer manifest;
+  };
+
   void doRefresh() {
     if (app == nullptr) return;
-    INetwork &net = app->device()->network();
-    if (!net.isConnected()) {
+    INetwork *net = &app->device()->network();
+    if (!net->isConnected()) {
       status = Status::Error;
       update();
       return;
     }
+    if (status == Status::Refreshing) return;
 
     status = Status::Refreshing;
     update();
-    lv_refr_now(NULL);
-
-    // 1. Invalidate server-side dynamic content cache
-    char url[128];
-    snprintf(url, sizeof(url), "%s/api/dynamic/refresh", OTA_UPDATE_URL);
-    HttpResponse resp = net.post(url, "{}", "application/json");
-
-    // 2. Re-fetch the UI manifest
-    snprintf(url, sizeof(url), "%s/api/ui/screens?board=%s",
-             OTA_UPDATE_URL, BOARD_ID);
-    HttpResponse manifestResp = net.get(url);
-    if (manifestResp.statusCode == 200) {
-      app->userScreenManager().loadManifest(manifestResp.body.c_str());
-    }
 
-    status = (resp.statusCode == 200) ? Status::Done : Status::Error;
-    update();
+    ServiceExecutor::run(
+        lifetime,
+        [net]() {
+          RefreshResult result;
+          // 1. Invalidate server-side dynamic content cache
+          char url[128];
+          snprintf(url, sizeof(url), "%s/api/dynamic/refresh", OTA_UPDATE_URL);
+          result.refreshStatus = net->post(url, "{}", "application/json").statusCode;
+
+          // 2. Re-fetch the UI manifest
+          snprintf(url, sizeof(url), "%s/api/ui/screens?board=%s",
+                   OTA_UPDATE_URL, BOARD_ID);
+          HttpResponse manifestResp = net->get(url);
+          result.manifestStatus = manifestResp.statusCode;
+          result.manifest = std::move(manifestResp.body);
+          return result;
+        },
+        [this](RefreshResult &result) {
+          // the manifest is UI state: load it here, on the UI loop
+          if (result.manifestStatus == 200) {
+            UserScreenManager &screens = app->userScreenManager();
+            if (screens.loadManifest(result.manifest.c_str()) && app->ha()) {
+              app->ha()->watchEntities(screens.entityIds());
+            }
+          }
+          status = (result.refreshStatus == 200) ? Status::Done : Status::Error;
+          update();
+        });
   }
 
 public:
@@ -94,6 +117,10 @@ public:
     }
   }
 
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (event.inputType != InputType::TouchInput) return;
     TouchEvent &te = static_cast<TouchEvent &>(event);
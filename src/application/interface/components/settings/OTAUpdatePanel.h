@@ -2,9 +2,11 @@
 #define _OTA_UPDATE_PANEL_H_
 
 #include "application/Application.h"
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/StatefulComponent.h"
 #include "application/interface/Toast.h"
 #include "application/services/OTAUpdate.h"
+#include "application/services/ServiceExecutor.h"
 #include "config/Version.h"
 #include "events/types/TouchEvent.h"
 
@@ -16,6 +18,12 @@ class OTAUpdatePanel : public StatefulComponent {
   lv_obj_t *statusLabel = nullptr;
   lv_obj_t *progressBar = nullptr;
   lv_obj_t *actionLabel = nullptr;
+  Lifetime lifetime;
+
+  struct CheckResult {
+    OTAStatus status;
+    String version;
+  };
 
 public:
   void createWidgets(lv_obj_t *parent) override {
@@ -130,6 +138,10 @@ public:
     }
   }
 
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (event.inputType != InputType::TouchInput) return;
     TouchEvent &te = static_cast<TouchEvent &>(event);
@@ -155,27 +167,33 @@ public:
         otaStatus == OTAStatus::Error) {
       otaStatus = OTAStatus::Checking;
       update();
-      lv_refr_now(NULL); // flush frame before blocking network call
-
-      bool hasUpdate = ota->checkForUpdate();
-
-      if (hasUpdate) {
-        otaStatus = OTAStatus::UpdateAvailable;
-        availableVersion = ota->availableVersion();
-      } else {
-        otaStatus = ota->status();
-      }
-      update();
-      lv_refr_now(NULL);
 
+      ServiceExecutor::run(
+          lifetime,
+          [ota]() {
+            CheckResult result;
+            if (ota->checkForUpdate()) {
+              result.status = OTAStatus::UpdateAvailable;
+              result.version = ota->availableVersion();
+            } else {
+              result.status = ota->status();
+            }
+            return result;
+          },
+          [this](CheckResult &result) {
+            otaStatus = result.status;
+            availableVersion = result.version;
+            update();
+          });
     } else if (otaStatus == OTAStatus::UpdateAvailable) {
       otaStatus = OTAStatus::Downloading;
       update();
       lv_refr_now(NULL); // flush "Downloading..." frame before blocking
 
-      // No display refresh during download — forcing a render mid-download
-      // crashes the ESP32 due to DMA contention (display + WiFi both use
-      // PSRAM DMA). Progress is logged to serial only.
+      // Stays on the UI loop, blocking it: no display refresh may happen
+      // during download — rendering mid-download crashes the ESP32 due to
+      // DMA contention (display + WiFi both use PSRAM DMA). Progress is
+      // logged to serial only.
       bool success = ota->performUpdate();
 
       otaStatus = ota->status();
@@ -1,6 +1,7 @@
 #ifndef _ROTATION_TOGGLE_H_
 #define _ROTATION_TOGGLE_H_
 
+#include "application/interface/components/HitTestIndex.h"
 #include "application/interface/components/types/StatefulComponent.h"
 #include "application/interface/components/input/Button.h"
 #include "events/types/TouchEvent.h"
@@ -38,6 +39,10 @@ public:
     lv_obj_set_style_text_color(valueLabel, lv_color_hex(0x3B82F6), 0);
   }
 
+  void registerHitTargets(HitTestIndex &index) override {
+    index.addTarget(this, lvObj);
+  }
+
   void handleEvent(InputEvent &event) override {
     if (event.inputType != InputType::TouchInput) return;
     TouchEvent &te = static_cast<TouchEvent &>(event);
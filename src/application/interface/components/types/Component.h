@@ -9,6 +9,7 @@
 
 // forward declaration
 class Application;
+class HitTestIndex;
 
 // helper define so you don't need the "new" keyword everywhere
 #define E(component, args...) new component(args)
@@ -31,6 +32,9 @@ struct Component : public EventHandler<InputEvent> {
   // only needed if this component uses event listeners or has
   // children that need their events handled
   virtual void handleEvent(InputEvent &event) {};
+  // adds this component's tap targets to the screen's hit-test index;
+  // anything that handles taps must register (see HitTestIndex)
+  virtual void registerHitTargets(HitTestIndex &index) {};
 };
 
 // convinience helper to keep track of which components
@@ -30,3 +30,9 @@ void ComponentWithChildren::handleEvent(InputEvent &event) {
     child->handleEvent(event);
   }
 }
+
+void ComponentWithChildren::registerHitTargets(HitTestIndex &index) {
+  for (auto &child : children) {
+    child->registerHitTargets(index);
+  }
+}
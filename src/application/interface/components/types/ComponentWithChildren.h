@@ -25,6 +25,8 @@ public:
   void createWidgets(lv_obj_t *parent) override;
   // by default, just pass event handling to all children
   virtual void handleEvent(InputEvent &event) override;
+  // by default, collect tap targets from all children
+  void registerHitTargets(HitTestIndex &index) override;
 };
 
 #endif // _COMPONENT_WITH_CHILDREN_H_
@@ -40,6 +40,12 @@ public:
       child->handleEvent(event);
     }
   }
+
+  void registerHitTargets(HitTestIndex &index) override {
+    for (auto *child : children) {
+      child->registerHitTargets(index);
+    }
+  }
 };
 
 #endif // _STATEFUL_COMPONENT_WITH_CHILDREN_H_
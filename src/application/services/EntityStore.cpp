@@ -0,0 +1,277 @@
+#include "application/services/EntityStore.h"
+
+#include "application/services/ServiceExecutor.h"
+#include "util/JsonAllocator.h"
+
+// Domains whose state moves slower (or faster) than HA_ENTITY_TTL_MS
+static const struct {
+  const char *domain;
+  uint32_t ttlMs;
+} DOMAIN_TTLS[] = {
+    {"weather", 5 * 60 * 1000}, // providers update every 10-30 min
+    {"sun", 5 * 60 * 1000},
+    {"sensor", 30 * 1000},
+    {"binary_sensor", 5 * 1000}, // presence, doors
+};
+
+// Attributes the HA components read; a component reading a new one must
+// add it here, or it will always come back empty
+static const char *const KEPT_ATTRIBUTES[] = {
+    "friendly_name",
+    "unit_of_measurement",
+    "device_class",
+    "temperature", // HAWeather
+    "temperature_unit",
+    "humidity",
+};
+
+const JsonDocument &EntitySnapshot::filter() {
+  static const JsonDocument filter = [] {
+    JsonDocument f(jsonAllocator());
+    f["entity_id"] = true;
+    f["state"] = true;
+    for (const char *key : KEPT_ATTRIBUTES) f["attributes"][key] = true;
+    return f;
+  }();
+  return filter;
+}
+
+bool EntitySnapshot::keepsAttribute(const char *attrKey) {
+  for (const char *key : KEPT_ATTRIBUTES) {
+    if (strcmp(key, attrKey) == 0) return true;
+  }
+  return false;
+}
+
+const String &EntitySnapshot::keptAttributes() {
+  static const String list = [] {
+    String l;
+    for (const char *key : KEPT_ATTRIBUTES) {
+      if (l.length() > 0) l += ",";
+      l += key;
+    }
+    return l;
+  }();
+  return list;
+}
+
+String EntitySnapshot::state() const {
+  if (!_doc) return "unavailable";
+  const char *state = (*_doc)["state"].as<const char *>();
+  return state ? String(state) : String("unavailable");
+}
+
+String EntitySnapshot::attribute(const char *attrKey) const {
+  if (!_doc) return "";
+  JsonVariantConst attr = (*_doc)["attributes"][attrKey];
+  if (attr.isNull()) return "";
+
+  // Return numeric values as strings too
+  if (attr.is<const char *>()) return String(attr.as<const char *>());
+  if (attr.is<float>()) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.1f", attr.as<float>());
+    return String(buf);
+  }
+  if (attr.is<int>()) return String(attr.as<int>());
+  return "";
+}
+
+bool EntitySnapshot::sameAs(const EntitySnapshot &other) const {
+  if (_doc == other._doc) return true;
+  if (!_doc || !other._doc) return false;
+  // deep comparison of state and attributes
+  return _doc->as<JsonVariantConst>() == other._doc->as<JsonVariantConst>();
+}
+
+// called with s.mutex held
+uint32_t EntityStore::ttlOf(State &s, const String &id) {
+  auto custom = s.ttls.find(id);
+  if (custom != s.ttls.end()) return custom->second;
+  int dot = id.indexOf('.');
+  if (dot > 0) {
+    String domain = id.substring(0, dot);
+    for (const auto &d : DOMAIN_TTLS) {
+      if (domain == d.domain) return d.ttlMs;
+    }
+  }
+  return HA_ENTITY_TTL_MS;
+}
+
+// called with s.mutex held: drop least recently used unwatched entries
+// until there is room for one more
+void EntityStore::evict(State &s) {
+  while (s.entries.size() >= HA_ENTITY_STORE_MAX) {
+    auto oldest = s.entries.end();
+    for (auto it = s.entries.begin(); it != s.entries.end(); ++it) {
+      if (!it->second.listeners.empty()) continue;
+      if (oldest == s.entries.end() ||
+          (int32_t)(it->second.lastUsed - oldest->second.lastUsed) < 0) {
+        oldest = it;
+      }
+    }
+    if (oldest == s.entries.end()) return; // everything is on screen
+    s.entries.erase(oldest);
+  }
+}
+
+EntityStore::Freshness EntityStore::lookup(const char *entityId,
+                                           EntitySnapshot &out) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  auto it = _state->entries.find(entityId);
+  if (it == _state->entries.end() || !it->second.snapshot.ok()) {
+    return Freshness::Missing;
+  }
+  Entry &e = it->second;
+  e.lastUsed = ++_state->clock;
+  out = e.snapshot;
+  if (e.stale) return Freshness::Stale;
+  if (e.live || millis() - e.fetchedAt < ttlOf(*_state, it->first)) {
+    return Freshness::Fresh;
+  }
+  return Freshness::Stale;
+}
+
+void EntityStore::put(const char *entityId, const EntitySnapshot &snapshot,
+                      bool live) {
+  store(entityId, snapshot, live, nullptr);
+}
+
+void EntityStore::putIfCurrent(const char *entityId,
+                               const EntitySnapshot &snapshot,
+                               uint32_t generation) {
+  store(entityId, snapshot, false, &generation);
+}
+
+uint32_t EntityStore::generation(const char *entityId) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  auto it = _state->entries.find(entityId);
+  return it == _state->entries.end() ? 0 : it->second.generation;
+}
+
+void EntityStore::store(const char *entityId, const EntitySnapshot &snapshot,
+                        bool live, const uint32_t *generation) {
+  if (!snapshot.ok()) return;
+  bool changed;
+  {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    auto it = _state->entries.find(entityId);
+    if (it == _state->entries.end()) {
+      evict(*_state);
+      it = _state->entries.emplace(entityId, Entry()).first;
+    } else if (generation && *generation != it->second.generation) {
+      return;
+    }
+    Entry &e = it->second;
+    // a REST response may have left HA before the last live update
+    if (!live && e.live && !e.stale) return;
+    if (live) e.live = true;
+    changed = !e.snapshot.sameAs(snapshot);
+    e.snapshot = snapshot;
+    e.fetchedAt = millis();
+    e.stale = false;
+    e.lastUsed = ++_state->clock;
+    changed = changed && !e.listeners.empty();
+  }
+  if (changed) notify(_state, entityId);
+}
+
+// Listeners run on the UI loop, looked up when the continuation runs so a
+// component unsubscribed (deleted) in the meantime is never called
+void EntityStore::notify(const std::shared_ptr<State> &state, const String &id) {
+  std::weak_ptr<State> weak = state;
+  ServiceExecutor::toUI([weak, id]() {
+    std::shared_ptr<State> s = weak.lock();
+    if (!s) return;
+    std::vector<uint32_t> tokens;
+    {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      auto it = s->entries.find(id);
+      if (it == s->entries.end()) return;
+      for (const Listener &l : it->second.listeners) tokens.push_back(l.token);
+    }
+    // one at a time: a listener may unsubscribe others, or itself
+    for (uint32_t token : tokens) {
+      EntitySnapshot snapshot;
+      std::function<void(const EntitySnapshot &)> fn;
+      {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        auto it = s->entries.find(id);
+        if (it == s->entries.end()) return;
+        for (const Listener &l : it->second.listeners) {
+          if (l.token == token) fn = l.fn;
+        }
+        snapshot = it->second.snapshot;
+      }
+      if (fn) fn(snapshot);
+    }
+  });
+}
+
+void EntityStore::endLive() {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  for (auto &kv : _state->entries) kv.second.live = false;
+}
+
+void EntityStore::invalidate(const char *entityId) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  auto it = _state->entries.find(entityId);
+  if (it != _state->entries.end()) {
+    it->second.stale = true;
+    it->second.generation++;
+  }
+}
+
+void EntityStore::setTTL(const char *entityId, uint32_t ttlMs) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  _state->ttls[entityId] = ttlMs;
+}
+
+bool EntityStore::watched(const char *entityId) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  auto it = _state->entries.find(entityId);
+  return it != _state->entries.end() && !it->second.listeners.empty();
+}
+
+EntityStore::Subscription EntityStore::subscribe(
+    const char *entityId, std::function<void(const EntitySnapshot &)> listener) {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  auto it = _state->entries.find(entityId);
+  if (it == _state->entries.end()) {
+    evict(*_state);
+    it = _state->entries.emplace(entityId, Entry()).first;
+  }
+  uint32_t token = _state->nextToken++;
+  it->second.listeners.push_back({token, std::move(listener)});
+  return Subscription(_state, it->first, token);
+}
+
+EntityStore::Subscription &
+EntityStore::Subscription::operator=(Subscription &&other) noexcept {
+  if (this != &other) {
+    reset();
+    _state = std::move(other._state);
+    _id = std::move(other._id);
+    _token = other._token;
+    other._token = 0;
+  }
+  return *this;
+}
+
+void EntityStore::Subscription::reset() {
+  std::shared_ptr<State> s = _state.lock();
+  _state.reset();
+  if (!s || _token == 0) return;
+  std::lock_guard<std::mutex> lock(s->mutex);
+  auto it = s->entries.find(_id);
+  if (it != s->entries.end()) {
+    auto &listeners = it->second.listeners;
+    for (auto l = listeners.begin(); l != listeners.end(); ++l) {
+      if (l->token == _token) {
+        listeners.erase(l);
+        break;
+      }
+    }
+  }
+  _token = 0;
+}
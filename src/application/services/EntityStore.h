@@ -0,0 +1,143 @@
+#ifndef _ENTITY_STORE_H_
+#define _ENTITY_STORE_H_
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// How long a fetched entity counts as fresh, unless its domain has its own
+// TTL (see EntityStore.cpp) or setTTL() overrides it
+#ifndef HA_ENTITY_TTL_MS
+#define HA_ENTITY_TTL_MS 10000
+#endif
+// Entities kept; the least recently used one without subscribers goes
+// first. A weather entity with a forecast is a few KB, most are < 1 KB.
+#ifndef HA_ENTITY_STORE_MAX
+#define HA_ENTITY_STORE_MAX 48
+#endif
+
+// One parsed /api/states/<entity> document. Copies share the document,
+// which is never modified after parsing, so any thread may read it.
+class EntitySnapshot {
+  std::shared_ptr<const JsonDocument> _doc;
+
+public:
+  EntitySnapshot() = default;
+  explicit EntitySnapshot(std::shared_ptr<const JsonDocument> doc)
+      : _doc(std::move(doc)) {}
+
+  // false if the request or the parse failed
+  bool ok() const { return _doc != nullptr; }
+  // "on", "off", ...; "unavailable" if !ok()
+  String state() const;
+  // attribute value as a string, numbers included; "" if missing or
+  // not one of the attributes kept (see filter())
+  String attribute(const char *attrKey) const;
+
+  bool sameAs(const EntitySnapshot &other) const;
+  // the parsed state document, or nullptr if !ok()
+  const JsonDocument *document() const { return _doc.get(); }
+
+  // What a snapshot keeps of a /api/states document: entity_id, state and
+  // the attributes components read. A DeserializationOption::Filter, so
+  // forecasts and the like are skipped while parsing, never stored.
+  static const JsonDocument &filter();
+  static bool keepsAttribute(const char *attrKey);
+  // The same attributes, comma-separated, for the control server's
+  // /ha/states?attrs= to trim with before sending
+  static const String &keptAttributes();
+};
+
+// Last known state of each entity HomeAssistant has read, so a screen
+// built again (tab switch, swipe back) renders at once instead of waiting
+// on HA. HomeAssistant serves reads from here and revalidates stale
+// entries in the background; when a refresh brings a change, subscribers
+// are told on the UI loop.
+//
+// Lookups and updates are safe from any thread. subscribe() and dropping
+// a Subscription belong on the UI loop, where listeners are called.
+class EntityStore {
+  struct Listener {
+    uint32_t token;
+    std::function<void(const EntitySnapshot &)> fn;
+  };
+  struct Entry {
+    EntitySnapshot snapshot;
+    unsigned long fetchedAt = 0;
+    bool stale = true; // no data yet, or invalidated
+    bool live = false; // kept current by the HA WebSocket subscription
+    uint32_t generation = 0; // invalidations so far
+    uint32_t lastUsed = 0;
+    std::vector<Listener> listeners;
+  };
+  struct State {
+    std::mutex mutex;
+    std::map<String, Entry> entries;
+    std::map<String, uint32_t> ttls; // setTTL() overrides
+    uint32_t clock = 0;              // LRU ticks
+    uint32_t nextToken = 1;
+  };
+  std::shared_ptr<State> _state = std::make_shared<State>();
+
+  static uint32_t ttlOf(State &s, const String &id);
+  static void evict(State &s);
+  static void notify(const std::shared_ptr<State> &state, const String &id);
+  void store(const char *entityId, const EntitySnapshot &snapshot, bool live,
+             const uint32_t *generation);
+
+public:
+  enum class Freshness { Missing, Stale, Fresh };
+
+  // Unsubscribes when destroyed; safe to outlive the store
+  class Subscription {
+    std::weak_ptr<State> _state;
+    String _id;
+    uint32_t _token = 0;
+
+  public:
+    Subscription() = default;
+    Subscription(std::weak_ptr<State> state, String id, uint32_t token)
+        : _state(std::move(state)), _id(std::move(id)), _token(token) {}
+    Subscription(Subscription &&other) noexcept { *this = std::move(other); }
+    Subscription &operator=(Subscription &&other) noexcept;
+    Subscription(const Subscription &) = delete;
+    Subscription &operator=(const Subscription &) = delete;
+    ~Subscription() { reset(); }
+
+    void reset();
+  };
+
+  // The cached snapshot, if any, and whether it is still within its TTL
+  Freshness lookup(const char *entityId, EntitySnapshot &out);
+  // Record a successful read; subscribers hear about it if it changed.
+  // Failed reads are not stored: the last good state stays on screen.
+  // Live updates (from the WebSocket subscription) stay fresh until
+  // endLive(), and a REST read can't overwrite them.
+  void put(const char *entityId, const EntitySnapshot &snapshot,
+           bool live = false);
+  // put() for a read sent at generation(): dropped if the entity was
+  // invalidated since, so a reply that left HA before a service call
+  // can't pass for the state after it
+  void putIfCurrent(const char *entityId, const EntitySnapshot &snapshot,
+                    uint32_t generation);
+  uint32_t generation(const char *entityId);
+  // The subscription dropped: live entries age by their TTL again
+  void endLive();
+  // Mark stale so the next read goes to HA (after a service call)
+  void invalidate(const char *entityId);
+  // Override the TTL for one entity
+  void setTTL(const char *entityId, uint32_t ttlMs);
+  // Anyone subscribed to this entity?
+  bool watched(const char *entityId);
+
+  // Call listener on the UI loop whenever a read brings a changed state
+  Subscription subscribe(const char *entityId,
+                         std::function<void(const EntitySnapshot &)> listener);
+};
+
+#endif // _ENTITY_STORE_H_
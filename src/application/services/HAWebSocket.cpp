@@ -0,0 +1,283 @@
+#include "application/services/HAWebSocket.h"
+
+#include <string.h>
+
+#include <random>
+
+#include "util/AllocTracker.h"
+#include "util/JsonAllocator.h"
+
+#ifndef BOARD_SIMULATOR
+#include <esp_pthread.h>
+#endif
+
+// How long one receive() blocks before the loop checks for a new entity
+// set, a due ping, or shutdown
+#define HA_WEBSOCKET_SLICE_MS 500
+
+HAWebSocket::HAWebSocket(INetwork *network, const char *baseUrl,
+                         const char *token, std::shared_ptr<EntityStore> store)
+    : _network(network), _token(token), _store(std::move(store)) {
+  _url = String(baseUrl) + "/api/websocket";
+#ifndef BOARD_SIMULATOR
+  esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+  cfg.stack_size = HA_WEBSOCKET_STACK;
+  cfg.prio = SERVICE_EXECUTOR_PRIORITY;
+  cfg.pin_to_core = SERVICE_EXECUTOR_CORE;
+  cfg.thread_name = "ha_ws";
+  esp_pthread_set_cfg(&cfg);
+#endif
+  _thread = std::thread([this]() { run(); });
+#ifndef BOARD_SIMULATOR
+  cfg = esp_pthread_get_default_config();
+  esp_pthread_set_cfg(&cfg);
+#endif
+}
+
+HAWebSocket::~HAWebSocket() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _wake.notify_all();
+  // at most one receive slice or connect timeout away
+  if (_thread.joinable()) _thread.join();
+  _store->endLive();
+}
+
+void HAWebSocket::watch(std::vector<String> ids) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _ids = std::move(ids);
+    _idsChanged = true;
+  }
+  _wake.notify_all();
+}
+
+bool HAWebSocket::sleep(uint32_t ms) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return !_wake.wait_for(lock, std::chrono::milliseconds(ms),
+                         [this] { return _stopping; });
+}
+
+void HAWebSocket::run() {
+  std::minstd_rand rng(millis());
+  uint32_t backoff = HA_WEBSOCKET_RECONNECT_MIN_MS;
+  for (;;) {
+    {
+      // nothing on screen references HA: stay disconnected
+      std::unique_lock<std::mutex> lock(_mutex);
+      _wake.wait(lock, [this] { return _stopping || !_ids.empty(); });
+      if (_stopping) return;
+    }
+
+    WebSocket ws(_network->createSocket());
+    SessionEnd end = session(ws);
+    ws.close();
+    if (_live) {
+      _live = false;
+      // entries age by their TTL again and REST reads take over
+      _store->endLive();
+    }
+    if (end == SessionEnd::Stopped) return;
+
+    if (end == SessionEnd::Dropped) {
+      backoff = HA_WEBSOCKET_RECONNECT_MIN_MS; // it worked until now
+    } else if (end == SessionEnd::AuthFailed) {
+      backoff = HA_WEBSOCKET_RECONNECT_MAX_MS; // retrying won't fix a token
+    }
+    // jitter up to a quarter, so panels sharing an HA don't reconnect in step
+    uint32_t wait = backoff + rng() % (backoff / 4 + 1);
+    Serial.printf("[HAWebSocket] reconnecting in %u ms\n", (unsigned)wait);
+    if (!sleep(wait)) return;
+    if (end != SessionEnd::Dropped) {
+      backoff = backoff * 2 < HA_WEBSOCKET_RECONNECT_MAX_MS
+                    ? backoff * 2
+                    : HA_WEBSOCKET_RECONNECT_MAX_MS;
+    }
+  }
+}
+
+HAWebSocket::SessionEnd HAWebSocket::session(WebSocket &ws) {
+  if (!_network->isConnected()) return SessionEnd::Failed;
+  if (!ws.connect(_url.c_str(), HA_WEBSOCKET_CONNECT_TIMEOUT_MS)) {
+    Serial.printf("[HAWebSocket] connect to %s failed\n", _url.c_str());
+    return SessionEnd::Failed;
+  }
+  if (!authenticate(ws)) {
+    return ws.connected() ? SessionEnd::AuthFailed : SessionEnd::Failed;
+  }
+  _nextId = 1;
+  _subscriptionId = 0;
+
+  unsigned long lastMessage = millis();
+  uint32_t pingId = 0;
+  unsigned long pingSentAt = 0;
+  std::string message;
+  for (;;) {
+    std::vector<String> ids;
+    bool resubscribe = false;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_stopping) return SessionEnd::Stopped;
+      if (_idsChanged || _subscriptionId == 0) {
+        ids = _ids;
+        _idsChanged = false;
+        resubscribe = true;
+      }
+    }
+    if (resubscribe) {
+      if (ids.empty()) return SessionEnd::Dropped; // nothing left to watch
+      if (!subscribe(ws, ids)) return SessionEnd::Dropped;
+    }
+
+    unsigned long now = millis();
+    if (pingId != 0 && now - pingSentAt >= HA_WEBSOCKET_PONG_TIMEOUT_MS) {
+      Serial.println("[HAWebSocket] no pong, reconnecting");
+      return SessionEnd::Dropped;
+    }
+    if (pingId == 0 && now - lastMessage >= HA_WEBSOCKET_PING_MS) {
+      pingId = _nextId++;
+      pingSentAt = now;
+      char ping[48];
+      int n = snprintf(ping, sizeof(ping), "{\"id\":%u,\"type\":\"ping\"}",
+                       (unsigned)pingId);
+      if (!ws.sendText(ping, n)) return SessionEnd::Dropped;
+    }
+
+    WebSocket::Result r = ws.receive(message, HA_WEBSOCKET_SLICE_MS);
+    if (r == WebSocket::Result::Closed) {
+      Serial.println("[HAWebSocket] connection closed");
+      return SessionEnd::Dropped;
+    }
+    if (r == WebSocket::Result::Timeout) continue;
+    lastMessage = millis();
+    pingId = 0; // anything from HA proves the connection is alive
+
+    AllocScope scope(AllocPhase::HAString);
+    JsonDocument doc(jsonAllocator());
+    if (deserializeJson(doc, message)) {
+      Serial.println("[HAWebSocket] unparseable message");
+      continue;
+    }
+    const char *type = doc["type"] | "";
+    uint32_t id = doc["id"] | 0u;
+    if (strcmp(type, "event") == 0 && id == _subscriptionId) {
+      handleEvent(doc["event"].as<JsonObjectConst>());
+    } else if (strcmp(type, "result") == 0 && !(doc["success"] | false)) {
+      Serial.printf("[HAWebSocket] request %u failed: %s\n", (unsigned)id,
+                    doc["error"]["message"] | "?");
+      // e.g. an HA too old for subscribe_entities: back off
+      if (id == _subscriptionId) return SessionEnd::Failed;
+    }
+  }
+}
+
+bool HAWebSocket::authenticate(WebSocket &ws) {
+  // auth_required, auth, then auth_ok or auth_invalid
+  std::string message;
+  for (int step = 0; step < 2; step++) {
+    if (ws.receive(message, HA_WEBSOCKET_CONNECT_TIMEOUT_MS) !=
+        WebSocket::Result::Message) {
+      Serial.println("[HAWebSocket] no auth reply");
+      return false;
+    }
+    JsonDocument doc(jsonAllocator());
+    if (deserializeJson(doc, message)) return false;
+    const char *type = doc["type"] | "";
+    if (step == 0) {
+      if (strcmp(type, "auth_required") != 0) return false;
+      JsonDocument auth(jsonAllocator());
+      auth["type"] = "auth";
+      auth["access_token"] = _token;
+      String body;
+      serializeJson(auth, body);
+      if (!ws.sendText(body)) return false;
+    } else if (strcmp(type, "auth_ok") != 0) {
+      Serial.printf("[HAWebSocket] %s: %s\n", type, doc["message"] | "");
+      return false;
+    }
+  }
+  Serial.println("[HAWebSocket] authenticated");
+  return true;
+}
+
+bool HAWebSocket::subscribe(WebSocket &ws, const std::vector<String> &ids) {
+  if (_subscriptionId != 0) {
+    char unsub[96];
+    int n = snprintf(unsub, sizeof(unsub),
+                     "{\"id\":%u,\"type\":\"unsubscribe_events\","
+                     "\"subscription\":%u}",
+                     (unsigned)_nextId++, (unsigned)_subscriptionId);
+    if (!ws.sendText(unsub, n)) return false;
+    // entities dropped from the set stop being updated; the new
+    // subscription's first event marks the rest live again
+    _store->endLive();
+  }
+  JsonDocument req(jsonAllocator());
+  _subscriptionId = _nextId++;
+  req["id"] = _subscriptionId;
+  req["type"] = "subscribe_entities";
+  JsonArray entityIds = req["entity_ids"].to<JsonArray>();
+  for (const String &id : ids) entityIds.add(id.c_str());
+  String body;
+  serializeJson(req, body);
+  Serial.printf("[HAWebSocket] subscribing to %d entities\n", (int)ids.size());
+  return ws.sendText(body);
+}
+
+// subscribe_entities events use HA's compressed state format:
+//   {"a": {id: {"s": state, "a": attributes, ...}}}   full states
+//   {"c": {id: {"+": {"s", "a"}, "-": {"a": [keys]}}}} changes
+//   {"r": [id, ...]}                                  removed
+// and are stored as /api/states documents, so components can't tell a
+// pushed state from a fetched one.
+void HAWebSocket::handleEvent(JsonObjectConst event) {
+  for (JsonPairConst kv : event["a"].as<JsonObjectConst>()) {
+    JsonObjectConst compressed = kv.value().as<JsonObjectConst>();
+    auto doc = std::make_shared<JsonDocument>(jsonAllocator());
+    (*doc)["entity_id"] = kv.key().c_str();
+    (*doc)["state"] = compressed["s"];
+    JsonObject attributes = (*doc)["attributes"].to<JsonObject>();
+    // trimmed like a REST read (see EntitySnapshot::filter())
+    for (JsonPairConst attr : compressed["a"].as<JsonObjectConst>()) {
+      if (EntitySnapshot::keepsAttribute(attr.key().c_str())) {
+        attributes[attr.key().c_str()] = attr.value();
+      }
+    }
+    _store->put(kv.key().c_str(), EntitySnapshot(std::move(doc)), true);
+  }
+  if (!_live && !event["a"].isNull()) {
+    _live = true;
+    Serial.println("[HAWebSocket] live");
+  }
+  for (JsonPairConst kv : event["c"].as<JsonObjectConst>()) {
+    applyDiff(kv.key().c_str(), kv.value().as<JsonObjectConst>());
+  }
+  for (JsonVariantConst id : event["r"].as<JsonArrayConst>()) {
+    _store->invalidate(id.as<const char *>());
+  }
+}
+
+void HAWebSocket::applyDiff(const char *entityId, JsonObjectConst diff) {
+  EntitySnapshot current;
+  if (_store->lookup(entityId, current) == EntityStore::Freshness::Missing) {
+    // nothing to apply it to (evicted): the next read fetches it whole
+    return;
+  }
+  // snapshots are shared and immutable: patch a copy
+  auto doc = std::make_shared<JsonDocument>(jsonAllocator());
+  doc->set(*current.document());
+  JsonObjectConst added = diff["+"];
+  if (!added["s"].isNull()) (*doc)["state"] = added["s"];
+  for (JsonPairConst attr : added["a"].as<JsonObjectConst>()) {
+    if (EntitySnapshot::keepsAttribute(attr.key().c_str())) {
+      (*doc)["attributes"][attr.key().c_str()] = attr.value();
+    }
+  }
+  JsonObject attributes = (*doc)["attributes"];
+  for (JsonVariantConst key : diff["-"]["a"].as<JsonArrayConst>()) {
+    attributes.remove(key.as<const char *>());
+  }
+  _store->put(entityId, EntitySnapshot(std::move(doc)), true);
+}
@@ -0,0 +1,91 @@
+#ifndef _HA_WEBSOCKET_H_
+#define _HA_WEBSOCKET_H_
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "application/services/EntityStore.h"
+#include "application/services/ServiceExecutor.h"
+#include "device/INetwork.h"
+#include "device/network/WebSocket.h"
+
+#ifndef HA_WEBSOCKET_STACK
+#define HA_WEBSOCKET_STACK 12288
+#endif
+#ifndef HA_WEBSOCKET_CONNECT_TIMEOUT_MS
+#define HA_WEBSOCKET_CONNECT_TIMEOUT_MS 5000
+#endif
+// Reconnect delay doubles from MIN to MAX while HA stays unreachable
+#ifndef HA_WEBSOCKET_RECONNECT_MIN_MS
+#define HA_WEBSOCKET_RECONNECT_MIN_MS 1000
+#endif
+#ifndef HA_WEBSOCKET_RECONNECT_MAX_MS
+#define HA_WEBSOCKET_RECONNECT_MAX_MS 60000
+#endif
+// Ping after this long without a message; no pong within the timeout
+// means the connection is dead (Wi-Fi dropped without a FIN)
+#ifndef HA_WEBSOCKET_PING_MS
+#define HA_WEBSOCKET_PING_MS 30000
+#endif
+#ifndef HA_WEBSOCKET_PONG_TIMEOUT_MS
+#define HA_WEBSOCKET_PONG_TIMEOUT_MS 10000
+#endif
+
+// Keeps EntityStore current over HA's WebSocket API instead of REST
+// polling: authenticates once, subscribe_entities for the ids the
+// manifest references, then applies HA's compressed state diffs as they
+// arrive. Subscribers to those entities hear about changes on the UI loop
+// as with any other store update; while the subscription is up their
+// entries never go stale, so REST reads are served from the store.
+//
+// Runs on its own thread pinned to SERVICE_EXECUTOR_CORE (it blocks in
+// receive() for as long as the connection is up, which would starve the
+// service worker), and reconnects with exponential backoff and jitter.
+class HAWebSocket {
+  INetwork *_network;
+  String _url;
+  String _token;
+  std::shared_ptr<EntityStore> _store;
+
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  bool _stopping = false;
+  std::vector<String> _ids; // guarded by _mutex
+  bool _idsChanged = false;
+  std::atomic<bool> _live{false};
+
+  // per connection, on the socket thread
+  uint32_t _nextId = 1;
+  uint32_t _subscriptionId = 0;
+
+  enum class SessionEnd { Failed, AuthFailed, Dropped, Stopped };
+
+  void run();
+  SessionEnd session(WebSocket &ws);
+  bool authenticate(WebSocket &ws);
+  bool subscribe(WebSocket &ws, const std::vector<String> &ids);
+  void handleEvent(JsonObjectConst event);
+  void applyDiff(const char *entityId, JsonObjectConst diff);
+  // false once stopping; otherwise sleeps up to ms
+  bool sleep(uint32_t ms);
+
+public:
+  HAWebSocket(INetwork *network, const char *baseUrl, const char *token,
+              std::shared_ptr<EntityStore> store);
+  ~HAWebSocket();
+
+  // Entities to keep subscribed; replaces the previous set. Any thread.
+  void watch(std::vector<String> ids);
+  // Subscribed and receiving updates right now
+  bool live() const { return _live; }
+};
+
+#endif // _HA_WEBSOCKET_H_
@@ -3,76 +3,284 @@
 #include <ArduinoJson.h>
 #include <Arduino.h>
 
+#include <algorithm>
+#include <future>
+
 #include "config/NetworkConfig.h"
+#include "util/AllocTracker.h"
+#include "util/JsonAllocator.h"
 
 HomeAssistant::HomeAssistant(INetwork *network, const char *baseUrl,
-                             const char *token)
-    : _network(network), _baseUrl(baseUrl), _token(token) {
+                             const char *token, const char *serverUrl)
+    : _network(network), _baseUrl(baseUrl), _token(token),
+      _serverUrl(serverUrl) {
   _authHeader = String("Bearer ") + token;
 }
 
-String HomeAssistant::getEntityState(const char *entityId) {
-  String url = String(_baseUrl) + "/api/states/" + entityId;
-  HttpResponse resp = _network->get(url.c_str(), _authHeader.c_str());
+HttpRequest HomeAssistant::stateRequest(const char *entityId) const {
+  HttpRequest req;
+  req.url = String(_baseUrl) + "/api/states/" + entityId;
+  req.authHeader = _authHeader;
+  req.timeoutMs = HA_REQUEST_TIMEOUT_MS;
+  return req;
+}
 
-  if (resp.statusCode != 200) {
-    Serial.printf("[HA] GET state failed: %d\n", resp.statusCode);
-    return "unavailable";
+// Parsed once per request, however many callers share it, straight off
+// the connection and through EntitySnapshot::filter(): a weather entity's
+// forecast is skipped, never buffered. A null document stands for a
+// failed read.
+static JsonDocument parseEntityBody(BodyStream &body) {
+  AllocScope scope(AllocPhase::HAString);
+  JsonDocument doc(jsonAllocator());
+  DeserializationError err = deserializeJson(
+      doc, body, DeserializationOption::Filter(EntitySnapshot::filter()));
+  if (err) {
+    Serial.printf("[HA] JSON parse error: %s\n", err.c_str());
+    doc.clear();
   }
+  return doc;
+}
 
-  JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, resp.body);
+// Anything but a 200
+static JsonDocument parseEntity(HttpResponse &resp) {
+  Serial.printf("[HA] GET state failed: %d\n", resp.statusCode);
+  return JsonDocument();
+}
+
+// Static, so a batch callback can fall back to it without holding this;
+// copies of a RequestCoalescer share its in-flight map
+void HomeAssistant::fetchEntity(RequestCoalescer<JsonDocument> states,
+                                INetwork *network, HttpRequest req,
+                                std::function<void(const EntitySnapshot &)> done) {
+  states.request(network, std::move(req), parseEntityBody, parseEntity,
+                 [done](const std::shared_ptr<const JsonDocument> &doc) {
+                   done(EntitySnapshot(doc->isNull() ? nullptr : doc));
+                 });
+}
+
+void HomeAssistant::fetchEntity(const char *entityId,
+                                std::function<void(const EntitySnapshot &)> done) {
+  fetchEntity(_states, _network, stateRequest(entityId), std::move(done));
+}
+
+// [{"entity_id", "state", "attributes"}, ...] from the control server,
+// streamed and filtered like a single read. Each entity gets a document
+// of its own, as if read by itself.
+static std::map<String, EntitySnapshot> parseBatch(BodyStream &body) {
+  AllocScope scope(AllocPhase::HAString);
+  static const JsonDocument filter = [] {
+    JsonDocument f(jsonAllocator());
+    f[0].set(EntitySnapshot::filter()); // [0]: every element
+    return f;
+  }();
+  std::map<String, EntitySnapshot> found;
+  JsonDocument doc(jsonAllocator());
+  DeserializationError err =
+      deserializeJson(doc, body, DeserializationOption::Filter(filter));
   if (err) {
-    Serial.printf("[HA] JSON parse error: %s\n", err.c_str());
-    return "unavailable";
+    Serial.printf("[HA] batch JSON parse error: %s\n", err.c_str());
+    return found;
   }
+  for (JsonObjectConst entity : doc.as<JsonArrayConst>()) {
+    const char *id = entity["entity_id"].as<const char *>();
+    if (id == nullptr) continue;
+    auto single = std::make_shared<JsonDocument>(jsonAllocator());
+    single->set(entity);
+    found[id] = EntitySnapshot(std::move(single));
+  }
+  return found;
+}
 
-  return String(doc["state"].as<const char *>());
+bool HomeAssistant::joinBatch(const char *entityId,
+                              std::function<void(const EntitySnapshot &)> done) {
+  std::lock_guard<std::mutex> lock(_batch->mutex);
+  auto it = _batch->waiting.find(entityId);
+  if (it == _batch->waiting.end()) return false;
+  if (done) it->second.push_back(std::move(done));
+  return true;
 }
 
-String HomeAssistant::getEntityAttribute(const char *entityId,
-                                         const char *attrKey) {
-  String url = String(_baseUrl) + "/api/states/" + entityId;
-  HttpResponse resp = _network->get(url.c_str(), _authHeader.c_str());
+void HomeAssistant::prefetch(const std::vector<String> &entityIds) {
+  if (_serverUrl == nullptr) return;
+  std::vector<String> ids;
+  {
+    std::lock_guard<std::mutex> lock(_batch->mutex);
+    for (const String &id : entityIds) {
+      EntitySnapshot cached;
+      if (_store->lookup(id.c_str(), cached) == EntityStore::Freshness::Fresh) {
+        continue;
+      }
+      if (_batch->waiting.count(id) > 0) continue; // already on its way
+      ids.push_back(id);
+    }
+    // a single entity is cheaper read by itself, straight from HA
+    if (ids.size() < 2) return;
+    for (const String &id : ids) _batch->waiting[id];
+  }
 
-  if (resp.statusCode != 200) {
-    Serial.printf("[HA] GET attr failed: %d\n", resp.statusCode);
-    return "";
+  for (size_t first = 0; first < ids.size(); first += HA_BATCH_MAX_ENTITIES) {
+    size_t last = std::min(ids.size(), first + HA_BATCH_MAX_ENTITIES);
+    std::vector<String> chunk(ids.begin() + first, ids.begin() + last);
+    // per-entity requests, for whatever the batch can't supply
+    std::map<String, HttpRequest> fallbacks;
+    std::map<String, uint32_t> generations;
+    String list;
+    for (const String &id : chunk) {
+      if (list.length() > 0) list += ",";
+      list += id;
+      fallbacks[id] = stateRequest(id.c_str());
+      generations[id] = _store->generation(id.c_str());
+    }
+
+    HttpRequest req;
+    req.url = String(_serverUrl) + "/api/datasources/ha/states?ids=" + list +
+              "&attrs=" + EntitySnapshot::keptAttributes();
+    req.timeoutMs = HA_REQUEST_TIMEOUT_MS;
+    std::shared_ptr<Batch> batch = _batch;
+    std::shared_ptr<EntityStore> store = _store;
+    RequestCoalescer<JsonDocument> states = _states;
+    INetwork *network = _network;
+    auto found = std::make_shared<std::map<String, EntitySnapshot>>();
+    req.onBody = [found](BodyStream &body) { *found = parseBatch(body); };
+    _network->request(std::move(req), [batch, store, states, network, chunk,
+                                       fallbacks, generations,
+                                       found](HttpResponse &resp) {
+      if (resp.statusCode != 200) {
+        Serial.printf("[HA] batch read failed: %d\n", resp.statusCode);
+      }
+      for (const String &id : chunk) {
+        std::vector<std::function<void(const EntitySnapshot &)>> waiters;
+        {
+          std::lock_guard<std::mutex> lock(batch->mutex);
+          auto it = batch->waiting.find(id);
+          if (it == batch->waiting.end()) continue;
+          waiters = std::move(it->second);
+          batch->waiting.erase(it);
+        }
+        auto entity = found->find(id);
+        if (entity != found->end()) {
+          store->putIfCurrent(id.c_str(), entity->second, generations.at(id));
+          for (auto &done : waiters) done(entity->second);
+        } else if (!waiters.empty()) {
+          // unknown to the server, or the batch failed: ask HA itself
+          for (auto &done : waiters) {
+            fetchEntity(states, network, fallbacks.at(id), std::move(done));
+          }
+        }
+      }
+    });
   }
+}
 
-  JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, resp.body);
-  if (err) {
-    Serial.printf("[HA] JSON parse error: %s\n", err.c_str());
-    return "";
+void HomeAssistant::readEntity(const char *entityId, bool allowStale,
+                               std::function<void(const EntitySnapshot &)> done) {
+  EntitySnapshot cached;
+  EntityStore::Freshness freshness = _store->lookup(entityId, cached);
+  if (freshness == EntityStore::Freshness::Fresh) {
+    if (done) done(cached);
+    return;
+  }
+  if (freshness == EntityStore::Freshness::Stale && allowStale) {
+    done(cached);
+    done = nullptr; // revalidate; subscribers hear about any change
   }
+  std::shared_ptr<EntityStore> store = _store;
+  String id = entityId;
+  uint32_t generation = _store->generation(entityId);
+  auto finish = [store, id, generation, cached, done](const EntitySnapshot &e) {
+    store->putIfCurrent(id.c_str(), e, generation);
+    // HA unreachable: the last known state beats "unavailable"
+    if (done) done(e.ok() ? e : cached);
+  };
+  // the screen's batched read is already fetching it
+  if (joinBatch(entityId, finish)) return;
+  fetchEntity(entityId, finish);
+}
 
-  JsonVariant attr = doc["attributes"][attrKey];
-  if (attr.isNull()) return "";
+void HomeAssistant::invalidate(const char *entityId) {
+  _store->invalidate(entityId);
+  // reads in flight were sent before the change: the next one goes out
+  // fresh instead of joining them
+  _states.forget(stateRequest(entityId).url);
+  std::vector<std::function<void(const EntitySnapshot &)>> batched;
+  {
+    std::lock_guard<std::mutex> lock(_batch->mutex);
+    auto it = _batch->waiting.find(entityId);
+    if (it != _batch->waiting.end()) {
+      batched = std::move(it->second);
+      _batch->waiting.erase(it); // its batch reply is dropped too
+    }
+  }
+  if (!batched.empty()) {
+    std::shared_ptr<EntityStore> store = _store;
+    String id = entityId;
+    uint32_t generation = _store->generation(entityId);
+    fetchEntity(entityId, [store, id, generation,
+                           batched](const EntitySnapshot &e) {
+      store->putIfCurrent(id.c_str(), e, generation);
+      for (auto &done : batched) done(e);
+    });
+  }
+  // anything showing it wants the new state now, not at its next read
+  if (_store->watched(entityId)) {
+    readEntity(entityId, false, nullptr);
+  }
+}
 
-  // Return numeric values as strings too
-  if (attr.is<const char *>()) return String(attr.as<const char *>());
-  if (attr.is<float>()) {
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%.1f", attr.as<float>());
-    return String(buf);
+void HomeAssistant::watchEntities(const std::vector<String> &entityIds) {
+#if HA_WEBSOCKET
+  if (!_live) {
+    if (entityIds.empty()) return;
+    // probe: the stub network has no sockets, so REST it is
+    std::unique_ptr<ISocket> probe = _network->createSocket();
+    if (!probe) return;
+    if (strncmp(_baseUrl, "https://", 8) == 0) {
+      Serial.println("[HA] wss:// not supported, staying on REST");
+      return;
+    }
+    _live.reset(new HAWebSocket(_network, _baseUrl, _token, _store));
   }
-  if (attr.is<int>()) return String(attr.as<int>());
-  return "";
+  _live->watch(entityIds);
+#endif
+}
+
+EntitySnapshot HomeAssistant::getEntity(const char *entityId) {
+  auto result = std::make_shared<std::promise<EntitySnapshot>>();
+  std::future<EntitySnapshot> snapshot = result->get_future();
+  readEntity(entityId, false,
+             [result](const EntitySnapshot &e) { result->set_value(e); });
+  return snapshot.get();
+}
+
+String HomeAssistant::getEntityState(const char *entityId) {
+  return getEntity(entityId).state();
+}
+
+String HomeAssistant::getEntityAttribute(const char *entityId,
+                                         const char *attrKey) {
+  return getEntity(entityId).attribute(attrKey);
 }
 
 static bool callService(INetwork *network, const char *baseUrl,
                         const char *authHeader, const char *domain,
                         const char *service, const char *entityId) {
+  AllocScope scope(AllocPhase::HAString);
   String url = String(baseUrl) + "/api/services/" + domain + "/" + service;
 
-  JsonDocument doc;
+  JsonDocument doc(jsonAllocator());
   doc["entity_id"] = entityId;
   String body;
   serializeJson(doc, body);
 
-  HttpResponse resp =
-      network->post(url.c_str(), body.c_str(), "application/json", authHeader);
+  // service calls come from taps: ahead of polls in the request queue
+  HttpRequest req;
+  req.method = HttpRequest::Method::Post;
+  req.url = url;
+  req.body = body;
+  req.authHeader = authHeader;
+  req.priority = RequestPriority::Interactive;
+  req.timeoutMs = HA_REQUEST_TIMEOUT_MS;
+  HttpResponse resp = network->send(std::move(req));
 
   if (resp.statusCode != 200) {
     Serial.printf("[HA] %s/%s failed: %d\n", domain, service,
@@ -90,17 +298,90 @@ static String domainOf(const char *entityId) {
   return id.substring(0, dot);
 }
 
+// Domains with turn_on/turn_off; others (cover, lock, ...) only share
+// toggle with them
+static const char *const ON_OFF_DOMAINS[] = {
+    "light",        "switch",  "fan",    "input_boolean", "automation",
+    "script",       "climate", "siren",  "media_player",  "humidifier",
+    "water_heater", "remote",  "camera", "group",
+};
+
+static bool hasOnOff(const String &domain) {
+  for (const char *d : ON_OFF_DOMAINS) {
+    if (domain == d) return true;
+  }
+  return false;
+}
+
+// a service call changes the entity, so its cached state goes too
 bool HomeAssistant::toggle(const char *entityId) {
-  return callService(_network, _baseUrl, _authHeader.c_str(),
-                     domainOf(entityId).c_str(), "toggle", entityId);
+  bool ok = callService(_network, _baseUrl, _authHeader.c_str(),
+                        domainOf(entityId).c_str(), "toggle", entityId);
+  invalidate(entityId);
+  return ok;
 }
 
 bool HomeAssistant::turnOn(const char *entityId) {
-  return callService(_network, _baseUrl, _authHeader.c_str(),
-                     domainOf(entityId).c_str(), "turn_on", entityId);
+  bool ok = callService(_network, _baseUrl, _authHeader.c_str(),
+                        domainOf(entityId).c_str(), "turn_on", entityId);
+  invalidate(entityId);
+  return ok;
 }
 
 bool HomeAssistant::turnOff(const char *entityId) {
-  return callService(_network, _baseUrl, _authHeader.c_str(),
-                     domainOf(entityId).c_str(), "turn_off", entityId);
+  bool ok = callService(_network, _baseUrl, _authHeader.c_str(),
+                        domainOf(entityId).c_str(), "turn_off", entityId);
+  invalidate(entityId);
+  return ok;
+}
+
+// entity ids are copied into the request: the manifest they point into
+// may be reloaded while it is queued
+
+NetworkCall<EntitySnapshot> HomeAssistant::entity(const char *entityId) {
+  String id = entityId;
+  return NetworkCall<EntitySnapshot>(
+      [this, id](NetworkCall<EntitySnapshot>::Deliver deliver) {
+        readEntity(id.c_str(), true, deliver);
+      });
+}
+
+NetworkCall<String> HomeAssistant::state(const char *entityId) {
+  String id = entityId;
+  return NetworkCall<String>([this, id](NetworkCall<String>::Deliver deliver) {
+    readEntity(id.c_str(), true, [deliver](const EntitySnapshot &e) {
+      deliver(e.state());
+    });
+  });
+}
+
+NetworkCall<String> HomeAssistant::attribute(const char *entityId,
+                                             const char *attrKey) {
+  String id = entityId;
+  String key = attrKey;
+  return NetworkCall<String>([this, id, key](NetworkCall<String>::Deliver deliver) {
+    readEntity(id.c_str(), true, [deliver, key](const EntitySnapshot &e) {
+      deliver(e.attribute(key.c_str()));
+    });
+  });
+}
+
+ServiceCall<CommandResult> HomeAssistant::switchTo(const char *entityId,
+                                                   bool on) {
+  String id = entityId;
+  return ServiceCall<CommandResult>([this, id, on]() {
+    CommandResult result;
+    if (hasOnOff(domainOf(id.c_str()))) {
+      result.ok = on ? turnOn(id.c_str()) : turnOff(id.c_str());
+    } else {
+      // toggle only if HA isn't there already, so an even number of
+      // collapsed taps sends nothing
+      EntitySnapshot current = getEntity(id.c_str());
+      bool isOn = current.state() == "on";
+      result.ok = (current.ok() && isOn == on) || toggle(id.c_str());
+    }
+    // read even after a failure: the caller rolls back to what HA has
+    result.entity = getEntity(id.c_str());
+    return result;
+  });
 }
@@ -1,18 +1,83 @@
 #ifndef _HOME_ASSISTANT_H_
 #define _HOME_ASSISTANT_H_
 
+#include <ArduinoJson.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "application/async/NetworkCall.h"
+#include "application/async/ServiceCall.h"
+#include "application/services/EntityStore.h"
+#include "application/services/HAWebSocket.h"
 #include "device/INetwork.h"
+#include "device/network/RequestCoalescer.h"
+
+// Deadline for every HA request, queueing included
+#define HA_REQUEST_TIMEOUT_MS 8000
+// Keep watched entities current over HA's WebSocket API; 0 leaves them
+// to REST reads and TTLs
+#ifndef HA_WEBSOCKET
+#define HA_WEBSOCKET 1
+#endif
+// Entities per batched read; longer screens are split into several
+#ifndef HA_BATCH_MAX_ENTITIES
+#define HA_BATCH_MAX_ENTITIES 24
+#endif
+
+// Outcome of a service call, and the state HA reported after it
+struct CommandResult {
+  bool ok = false;
+  EntitySnapshot entity; // !ok() if the read back failed too
+};
 
 class HomeAssistant {
 private:
   INetwork *_network;
   const char *_baseUrl;
   const char *_token;
+  // Control server, for batched reads; nullptr: one request per entity
+  const char *_serverUrl;
   // Prebuilt auth header: "Bearer <token>"
   String _authHeader;
+  // Every entity read goes through here, so concurrent reads of one
+  // entity (several attributes, several components) share one request
+  RequestCoalescer<JsonDocument> _states;
+  // Shared with in-flight callbacks, which may finish after we are gone
+  std::shared_ptr<EntityStore> _store = std::make_shared<EntityStore>();
+  // Started by the first watchEntities(), if the network can open sockets
+  std::unique_ptr<HAWebSocket> _live;
+  // Entities a prefetch() is fetching right now, and the reads waiting on
+  // it. Shared with the request's callback.
+  struct Batch {
+    std::mutex mutex;
+    std::map<String, std::vector<std::function<void(const EntitySnapshot &)>>>
+        waiting;
+  };
+  std::shared_ptr<Batch> _batch = std::make_shared<Batch>();
+
+  HttpRequest stateRequest(const char *entityId) const;
+  // Calls done on the network thread
+  static void fetchEntity(RequestCoalescer<JsonDocument> states,
+                          INetwork *network, HttpRequest req,
+                          std::function<void(const EntitySnapshot &)> done);
+  void fetchEntity(const char *entityId,
+                   std::function<void(const EntitySnapshot &)> done);
+  // Wait for the prefetch() that is fetching this entity, if any
+  bool joinBatch(const char *entityId,
+                 std::function<void(const EntitySnapshot &)> done);
+  // From the store when fresh (or stale, if allowed: then revalidated in
+  // the background), else from HA. done may run before this returns.
+  void readEntity(const char *entityId, bool allowStale,
+                  std::function<void(const EntitySnapshot &)> done);
+  void invalidate(const char *entityId);
 
 public:
-  HomeAssistant(INetwork *network, const char *baseUrl, const char *token);
+  HomeAssistant(INetwork *network, const char *baseUrl, const char *token,
+                const char *serverUrl = nullptr);
 
   // Get the state string for an entity (e.g., "on", "off", "unavailable")
   String getEntityState(const char *entityId);
@@ -26,6 +91,42 @@ public:
   // Explicit on/off. Returns true on success.
   bool turnOn(const char *entityId);
   bool turnOff(const char *entityId);
+
+  // Cached entity states, TTLs and change subscriptions
+  EntityStore &entities() { return *_store; }
+  // What the store has for this entity, fresh or stale, so a component can
+  // render it with the screen instead of waiting on a read; false if none
+  bool cached(const char *entityId, EntitySnapshot &out) {
+    return _store->lookup(entityId, out) != EntityStore::Freshness::Missing;
+  }
+
+  // Entities the UI may show (all of them, not just this screen's): kept
+  // current in the store by a WebSocket subscription, where supported
+  void watchEntities(const std::vector<String> &entityIds);
+
+  // A screen is about to show these: read the ones not fresh in the store
+  // with one request to the control server instead of one each. Reads of
+  // them until it answers wait for it; anything it can't supply falls
+  // back to a per-entity read.
+  void prefetch(const std::vector<String> &entityIds);
+
+  // Blocking read of the whole entity, for service worker jobs; skips the
+  // store unless its entry is fresh
+  EntitySnapshot getEntity(const char *entityId);
+
+  // Awaitable variants for Tasks; the awaiting task resumes on the UI loop
+  // with the result. Reads are queued requests, parsed off the UI loop.
+  // Read several fields of one entity through entity(): one request.
+  // These accept a stale cached state and revalidate it in the background;
+  // subscribe through entities() to hear the outcome.
+  NetworkCall<EntitySnapshot> entity(const char *entityId);
+  NetworkCall<String> state(const char *entityId);
+  NetworkCall<String> attribute(const char *entityId, const char *attrKey);
+  // Turn on or off, then read the state back (on the service worker).
+  // Idempotent, unlike toggle, so repeated taps can be collapsed into one
+  // call for the last one. Domains without turn_on/turn_off (cover, lock)
+  // get a toggle, sent only when HA's state differs from on.
+  ServiceCall<CommandResult> switchTo(const char *entityId, bool on);
 };
 
 #endif // _HOME_ASSISTANT_H_
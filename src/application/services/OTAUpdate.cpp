@@ -5,6 +5,7 @@
 
 #include "config/NetworkConfig.h"
 #include "config/Version.h"
+#include "util/JsonAllocator.h"
 
 #ifndef BOARD_SIMULATOR
 #include <WiFi.h>
@@ -39,8 +40,8 @@ bool OTAUpdate::checkForUpdate() {
     return false;
   }
 
-  JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, resp.body);
+  JsonDocument doc(jsonAllocator());
+  DeserializationError err = deserializeJson(doc, resp.body.c_str(), resp.body.size());
   if (err) {
     Serial.printf("[OTA] JSON parse error: %s\n", err.c_str());
     _status = OTAStatus::Error;
@@ -0,0 +1,126 @@
+#include <Arduino.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "application/services/ServiceExecutor.h"
+#include "util/WakeSignal.h"
+
+#ifndef BOARD_SIMULATOR
+#include <esp_pthread.h>
+#endif
+
+static std::mutex s_jobMutex;
+static std::condition_variable s_jobReady;
+static std::deque<std::function<void()>> s_jobs;
+static bool s_stopping = false;
+static std::thread s_worker;
+
+static std::mutex s_uiMutex;
+static std::vector<std::function<void()>> s_continuations;
+
+#ifndef SIM_HEADLESS
+static void workerMain() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(s_jobMutex);
+      s_jobReady.wait(lock, [] { return s_stopping || !s_jobs.empty(); });
+      if (s_stopping) return;
+      job = std::move(s_jobs.front());
+      s_jobs.pop_front();
+    }
+    job();
+  }
+}
+#endif
+
+void ServiceExecutor::begin() {
+  {
+    std::lock_guard<std::mutex> lock(s_jobMutex);
+    s_stopping = false;
+  }
+#ifndef SIM_HEADLESS
+  if (s_worker.joinable()) return;
+#ifndef BOARD_SIMULATOR
+  esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+  cfg.stack_size = SERVICE_EXECUTOR_STACK;
+  cfg.prio = SERVICE_EXECUTOR_PRIORITY;
+  cfg.pin_to_core = SERVICE_EXECUTOR_CORE;
+  cfg.thread_name = "services";
+  esp_pthread_set_cfg(&cfg);
+#endif
+  s_worker = std::thread(workerMain);
+#ifndef BOARD_SIMULATOR
+  // later std::threads get the defaults again
+  cfg = esp_pthread_get_default_config();
+  esp_pthread_set_cfg(&cfg);
+  Serial.printf("[ServiceExecutor] worker started on core %d\n",
+                SERVICE_EXECUTOR_CORE);
+#endif
+#endif
+}
+
+void ServiceExecutor::end() {
+  {
+    std::lock_guard<std::mutex> lock(s_jobMutex);
+    s_stopping = true;
+    s_jobs.clear();
+  }
+  s_jobReady.notify_all();
+  // the job in flight, if any, finishes first; its continuation is dropped
+  if (s_worker.joinable()) s_worker.join();
+  std::lock_guard<std::mutex> lock(s_uiMutex);
+  s_continuations.clear();
+}
+
+void ServiceExecutor::post(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(s_jobMutex);
+    if (s_stopping) return;
+    s_jobs.push_back(std::move(job));
+  }
+  s_jobReady.notify_one();
+}
+
+void ServiceExecutor::toUI(std::function<void()> continuation) {
+  {
+    std::lock_guard<std::mutex> lock(s_uiMutex);
+    s_continuations.push_back(std::move(continuation));
+  }
+  WakeSignal::notify();
+}
+
+void ServiceExecutor::drain() {
+#ifdef SIM_HEADLESS
+  // no worker: run the jobs queued so far on the loop thread
+  std::deque<std::function<void()>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(s_jobMutex);
+    jobs.swap(s_jobs);
+  }
+  for (auto &job : jobs) job();
+#endif
+  // swap out under the lock, so continuations can queue more (or the
+  // worker can finish another job) while these run
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<std::mutex> lock(s_uiMutex);
+    ready.swap(s_continuations);
+  }
+  for (auto &continuation : ready) continuation();
+}
+
+bool ServiceExecutor::pending() {
+#ifdef SIM_HEADLESS
+  {
+    std::lock_guard<std::mutex> lock(s_jobMutex);
+    if (!s_jobs.empty()) return true;
+  }
+#endif
+  std::lock_guard<std::mutex> lock(s_uiMutex);
+  return !s_continuations.empty();
+}
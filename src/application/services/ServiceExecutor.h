@@ -0,0 +1,95 @@
+#ifndef _SERVICE_EXECUTOR_H_
+#define _SERVICE_EXECUTOR_H_
+
+#include <functional>
+#include <memory>
+
+// Core the service worker is pinned to. The Arduino loop task (LVGL, input,
+// ComponentManager) runs on ARDUINO_RUNNING_CORE, core 1 by default; the
+// Wi-Fi/lwIP tasks already live on core 0, next to the HTTP work.
+#ifndef SERVICE_EXECUTOR_CORE
+#define SERVICE_EXECUTOR_CORE 0
+#endif
+#ifndef SERVICE_EXECUTOR_STACK
+#define SERVICE_EXECUTOR_STACK 8192
+#endif
+#ifndef SERVICE_EXECUTOR_PRIORITY
+#define SERVICE_EXECUTOR_PRIORITY 1
+#endif
+
+// Held by anything that starts background work which calls back into it
+// (usually a component). Continuations check it on the UI thread before
+// running, so a component deleted by a screen change mid-request is simply
+// skipped rather than called through a dangling pointer.
+class Lifetime {
+  std::shared_ptr<bool> token = std::make_shared<bool>(true);
+
+public:
+  Lifetime() = default;
+  Lifetime(const Lifetime &) = delete;
+  Lifetime &operator=(const Lifetime &) = delete;
+
+  std::weak_ptr<bool> watch() const { return token; }
+};
+
+// Threading model: the UI loop owns LVGL, input and every component; one
+// service worker runs blocking multi-step work (HA service calls, OTA
+// checks, content refresh); single requests go straight to
+// INetwork::request() instead (see NetworkCall). Work goes to the worker
+// with post(); results come back through a continuation queue that
+// Application::loop drains, so widgets are only ever touched from the UI
+// loop.
+//
+//   ESP32:          std::thread pinned to SERVICE_EXECUTOR_CORE via
+//                   esp_pthread_set_cfg
+//   SDL simulator:  std::thread
+//   headless:       no thread; queued jobs run inline from drain(), so
+//                   replays and benchmarks stay deterministic on the
+//                   virtual clock
+//
+// Jobs run one at a time, in order, so services need no locking of their
+// own. Work lambdas must capture what they need by value: they run on the
+// worker and must not touch components or LVGL.
+//
+// Usage (from a component):
+//   ServiceExecutor::run(lifetime,
+//       [ha, id]() { return ha->getEntityState(id); },
+//       [this](String &state) { entityState = state; update(); });
+//
+class ServiceExecutor {
+public:
+  // Start the worker; called once from Application::init
+  static void begin();
+  // Stop and join the worker, dropping queued jobs and continuations
+  static void end();
+
+  // Queue a job for the service worker. Safe from any thread.
+  static void post(std::function<void()> job);
+  // Queue a continuation for the UI loop and wake it. Safe from any thread.
+  static void toUI(std::function<void()> continuation);
+
+  // Run work() on the worker, then done(result) on the UI loop, as long as
+  // owner is still alive. Skips the work too if owner dies while queued.
+  template <typename Work, typename Done>
+  static void run(const Lifetime &owner, Work work, Done done);
+
+  // UI loop: run continuations queued since the last drain
+  static void drain();
+  // Continuations (or, headless, jobs) waiting for drain()
+  static bool pending();
+};
+
+template <typename Work, typename Done>
+void ServiceExecutor::run(const Lifetime &owner, Work work, Done done) {
+  using Result = decltype(work());
+  std::weak_ptr<bool> alive = owner.watch();
+  post([alive, work, done]() mutable {
+    if (alive.expired()) return;
+    auto result = std::make_shared<Result>(work());
+    toUI([alive, result, done]() mutable {
+      if (!alive.expired()) done(*result);
+    });
+  });
+}
+
+#endif // _SERVICE_EXECUTOR_H_
@@ -3,6 +3,7 @@
 #include "application/Application.h"
 #include "application/workflow/Workflow.h"
 #include "events/types/WorkflowEvent.h"
+#include "util/LatencyTracer.h"
 
 State Workflow::getState() { return this->state; }
 
@@ -32,6 +33,7 @@ void Workflow::navigate(State newState) {
     prevUserState = state;
   }
 
+  LatencyTracer::markActive(LatencyStage::Navigate);
   prevState = state;
   state = newState;
   WorkflowEvent event = {.from = prevState, .to = state, .timestamp = millis()};
@@ -3,6 +3,11 @@
 
 #include "util/Timer.h"
 
+// A navigate() this soon after the previous one is dropped
+#ifndef WORKFLOW_DEBOUNCE_MS
+#define WORKFLOW_DEBOUNCE_MS 100
+#endif
+
 class Application;
 
 // State is an int — system states are named constants 0-31,
@@ -26,7 +31,7 @@ private:
   State state = NOT_STARTED;
   State prevState = NOT_STARTED;
   State prevUserState = USER_STATE_BASE; // last user screen (for shade return)
-  Timer debounceTimer{100};
+  Timer debounceTimer{WORKFLOW_DEBOUNCE_MS};
 
 public:
   Workflow(Application *app) : app(app) {};
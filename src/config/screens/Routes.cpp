@@ -48,7 +48,11 @@ RenderableComponent createComponentFromState(State state, Application *app) {
 
   // User surface — try JSON manifest, fall back to placeholder
   if (app != nullptr && app->userScreenManager().hasScreen(state)) {
-    Component *c = app->userScreenManager().buildScreen(state, app->registry());
+    std::vector<String> entityIds;
+    Component *c = app->userScreenManager().buildScreen(state, app->registry(),
+                                                        &entityIds);
+    // one request for the whole screen, out before the components ask
+    if (c != nullptr && app->ha() != nullptr) app->ha()->prefetch(entityIds);
     if (c != nullptr) return wrapUserScreen(state, c, app);
   }
 
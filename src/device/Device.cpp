@@ -1,5 +1,7 @@
 #include "lvgl.h"
 #include "device/Device.h"
+#include "util/LatencyTracer.h"
+#include "util/RenderProfiler.h"
 
 #ifdef BOARD_MAKERFABS_ROUND_128
 #include "device/hw/drivers/gc9a01/GC9A01Display.h"
@@ -16,6 +18,7 @@
 #elif defined(BOARD_SIMULATOR)
 #include "SimDrivers.h"
 #include "platform/CurlNetwork.h"
+#include "platform/StubNetwork.h"
 #endif
 
 Device::Device() {
@@ -30,10 +33,18 @@ Device::Device() {
   _storage = new NoStorage();
   _network = new ArduinoNetwork();
 #elif defined(BOARD_SIMULATOR)
+#ifdef SIM_HEADLESS
+  _display = new MemoryDisplayDriver();
+#else
   _display = new SimDisplayDriver();
+#endif
   _touch = new SimTouchDriver();
   _storage = new SimStorageDriver();
-  _network = new CurlNetwork();
+  if (StubNetwork::enabled()) {
+    _network = new StubNetwork();
+  } else {
+    _network = new CurlNetwork();
+  }
 #endif
 }
 
@@ -79,11 +90,15 @@ void Device::init() {
   _touch->init();
 
   lv_init();
-#ifndef BOARD_SIMULATOR
+  // SDL simulator gets its tick from the SDL driver; headless millis() is virtual
+#if !defined(BOARD_SIMULATOR) || defined(SIM_HEADLESS)
   lv_tick_set_cb((lv_tick_get_cb_t)millis);
 #endif
 
-  _display->initLVGL();
+  lv_display_t *disp = _display->initLVGL();
+  _touch->initLVGL();
+  RenderProfiler::attach(disp);
+  LatencyTracer::attach(disp);
 }
 
 IDisplay &Device::display() { return *_display; }
@@ -3,23 +3,114 @@
 
 #include <Arduino.h>
 
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "device/ISocket.h"
+#include "device/network/BodyStream.h"
+#include "device/network/ResponseBuffer.h"
+
+// HttpResponse::statusCode values that are not HTTP statuses
+#define HTTP_ERROR_FAILED -1   // not connected, or the transport failed
+#define HTTP_ERROR_DEADLINE -2 // the request's deadline passed first
+#define HTTP_ERROR_TOO_LARGE -3 // body over RESPONSE_BUFFER_MAX
+
+// Move-only: the body is a pooled block, handed along rather than copied
 struct HttpResponse {
-  int statusCode = -1;
-  String body;
+  int statusCode = HTTP_ERROR_FAILED;
+  ResponseBuffer body;
   String etag;
 };
 
+// Queued requests are started highest priority first, FIFO within a level
+enum class RequestPriority : uint8_t {
+  Background,  // polls and prefetches
+  Normal,
+  Interactive, // the user is waiting on it (a tap)
+  Count,
+};
+
+struct HttpRequest {
+  enum class Method : uint8_t { Get, Post };
+
+  Method method = Method::Get;
+  String url;
+  String body;                        // POST only
+  String contentType = "application/json";
+  String authHeader;                  // empty: none
+  String ifNoneMatch;                 // empty: none
+  RequestPriority priority = RequestPriority::Normal;
+  // Give up this long after request() is called, queueing included;
+  // 0 uses the driver's own connect/read timeouts
+  uint32_t timeoutMs = 0;
+  // Set to read a 200 body as it arrives instead of having it buffered in
+  // HttpResponse::body, which then stays empty: parse it with a filter
+  // and only what the filter keeps is ever in RAM. Runs on the network
+  // thread just before the callback; what it leaves unread is skipped.
+  std::function<void(BodyStream &)> onBody;
+};
+
+// Runs exactly once per request, on a network thread (inline in headless
+// builds). Keep it short and hand results to the UI loop with
+// ServiceExecutor::toUI; the response may be moved from.
+using HttpCallback = std::function<void(HttpResponse &)>;
+
 class INetwork {
 public:
   virtual ~INetwork() = default;
   virtual void init() = 0;
   virtual bool isConnected() = 0;
-  virtual HttpResponse get(const char *url,
-                           const char *authHeader = nullptr,
-                           const char *ifNoneMatch = nullptr) = 0;
-  virtual HttpResponse post(const char *url, const char *body,
-                            const char *contentType = "application/json",
-                            const char *authHeader = nullptr) = 0;
+
+  // Queue a request and return at once; onDone gets the response, or a
+  // statusCode of HTTP_ERROR_FAILED / HTTP_ERROR_DEADLINE /
+  // HTTP_ERROR_TOO_LARGE
+  virtual void request(HttpRequest req, HttpCallback onDone) = 0;
+
+  // A raw TCP socket, or nullptr where there is none to give (the
+  // simulator's in-process stub, headless runs)
+  virtual std::unique_ptr<ISocket> createSocket() { return nullptr; }
+
+  // For drivers that received a 200 body whole: hand it to req.onBody,
+  // as if streamed, and free it
+  static void streamBuffered(const HttpRequest &req, HttpResponse &resp) {
+    if (!req.onBody || resp.statusCode != 200) return;
+    BufferedBodyStream body(resp.body.data(), resp.body.size());
+    req.onBody(body);
+    resp.body.reset();
+  }
+
+  // Blocking wrappers over request(), for code already off the UI loop
+  // (service worker jobs, boot). Never call from an HttpCallback.
+  HttpResponse send(HttpRequest req) {
+    auto done = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> response = done->get_future();
+    request(std::move(req),
+            [done](HttpResponse &resp) { done->set_value(std::move(resp)); });
+    return response.get();
+  }
+
+  HttpResponse get(const char *url,
+                   const char *authHeader = nullptr,
+                   const char *ifNoneMatch = nullptr) {
+    HttpRequest req;
+    req.url = url;
+    if (authHeader) req.authHeader = authHeader;
+    if (ifNoneMatch) req.ifNoneMatch = ifNoneMatch;
+    return send(std::move(req));
+  }
+
+  HttpResponse post(const char *url, const char *body,
+                    const char *contentType = "application/json",
+                    const char *authHeader = nullptr) {
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = url;
+    req.body = body;
+    req.contentType = contentType;
+    if (authHeader) req.authHeader = authHeader;
+    return send(std::move(req));
+  }
 };
 
 #endif // _INETWORK_H_
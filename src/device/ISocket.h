@@ -0,0 +1,23 @@
+#ifndef _ISOCKET_H_
+#define _ISOCKET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A blocking TCP stream, for long-lived connections that don't fit the
+// request/response INetwork API (the HA WebSocket). One thread at a time.
+class ISocket {
+public:
+  virtual ~ISocket() = default;
+
+  virtual bool connect(const char *host, uint16_t port, uint32_t timeoutMs) = 0;
+  virtual bool connected() = 0;
+  // Bytes read into buf; 0 if nothing arrived within timeoutMs, -1 once
+  // the connection is closed or broken
+  virtual int read(uint8_t *buf, size_t len, uint32_t timeoutMs) = 0;
+  // Write all of data; false if the connection broke
+  virtual bool write(const uint8_t *data, size_t len) = 0;
+  virtual void close() = 0;
+};
+
+#endif // _ISOCKET_H_
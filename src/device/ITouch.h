@@ -1,6 +1,9 @@
 #ifndef _ITOUCH_H_
 #define _ITOUCH_H_
 
+#include "lvgl.h"
+
+#include "device/types/TouchLocation.h"
 #include "events/EventSource.h"
 #include "events/types/InputEvent.h"
 
@@ -8,6 +11,67 @@ class ITouch : public EventSource<InputEvent> {
 public:
   virtual ~ITouch() {}
   virtual void init() = 0;
+
+  // Live contact state, in panel coordinates (LVGL applies the display
+  // rotation itself). Drivers refresh it while polling, so reading it
+  // costs no bus traffic. While released, location is the last contact.
+  virtual bool pointer(TouchLocation &location) { return false; }
+
+  // Register the touchscreen as LVGL's pointer input device, giving native
+  // press states and drag/kinetic scrolling. Called after lv_init() and
+  // the display is created. Gestures still arrive through pollEvent().
+  //
+  // The indev is event-driven rather than polled by an LVGL timer, so an
+  // idle screen leaves no timer due; Application::loop feeds it with
+  // updateLVGL() after polling.
+  lv_indev_t *initLVGL() {
+    _indev = lv_indev_create();
+    lv_indev_set_type(_indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(_indev, readPointer);
+    lv_indev_set_user_data(_indev, this);
+    lv_indev_set_mode(_indev, LV_INDEV_MODE_EVENT);
+    return _indev;
+  }
+
+  // Hand LVGL the pointer while a contact, its release, or a scroll throw
+  // is in progress
+  void updateLVGL() {
+    if (_indev == nullptr) return;
+    TouchLocation location;
+    bool pressed = pointer(location);
+    if (pressed || _lvglPressed || isScrolling()) lv_indev_read(_indev);
+    _lvglPressed = pressed;
+  }
+
+  lv_indev_t *indev() { return _indev; }
+
+  // True while LVGL is drag- or throw-scrolling on behalf of this pointer
+  bool isScrolling() {
+    return _indev != nullptr && lv_indev_get_scroll_obj(_indev) != nullptr;
+  }
+
+  // Gesture recognition waiting on a timeout (long press, double tap)
+  virtual bool gesturesPending() { return false; }
+
+  // Input needs the loop at frame rate: finger down, gesture timer
+  // running, or scroll momentum
+  bool active() {
+    TouchLocation location;
+    return pointer(location) || gesturesPending() || isScrolling();
+  }
+
+private:
+  lv_indev_t *_indev = nullptr;
+  bool _lvglPressed = false;
+
+  static void readPointer(lv_indev_t *indev, lv_indev_data_t *data) {
+    auto *self = static_cast<ITouch *>(lv_indev_get_user_data(indev));
+    TouchLocation location;
+    bool pressed = self->pointer(location);
+    data->point.x = location.x;
+    data->point.y = location.y;
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  }
 };
 
 #endif // _ITOUCH_H_
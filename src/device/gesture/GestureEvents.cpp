@@ -0,0 +1,82 @@
+#include <stdlib.h>
+
+#include "device/gesture/GestureEvents.h"
+
+#include "BoardConfig.h"
+#include "events/types/TouchEvent.h"
+#include "lvgl.h"
+#include "util/LatencyTracer.h"
+
+static bool flipped() {
+  return lv_display_get_rotation(NULL) == LV_DISPLAY_ROTATION_180;
+}
+
+TouchLocation GestureEvents::toDisplay(int x, int y) {
+  if (flipped()) {
+    x = SCREEN_WIDTH - 1 - x;
+    y = SCREEN_HEIGHT - 1 - y;
+  }
+  return {x, y};
+}
+
+static SwipeDirection swipeDirection(TouchLocation from, TouchLocation to) {
+  int dx = to.x - from.x;
+  int dy = to.y - from.y;
+  if (abs(dx) > abs(dy)) {
+    return dx > 0 ? SwipeDirection::SwipeRight : SwipeDirection::SwipeLeft;
+  }
+  return dy > 0 ? SwipeDirection::SwipeDown : SwipeDirection::SwipeUp;
+}
+
+void GestureEvents::deliver(GestureRecognizer &recognizer,
+                            EventHandler<InputEvent> *handler) {
+  Gesture g;
+  while (recognizer.poll(g)) {
+    TouchLocation start = toDisplay(g.startX, g.startY);
+    TouchLocation at = toDisplay(g.x, g.y);
+    int vx = flipped() ? -g.vx : g.vx;
+    int vy = flipped() ? -g.vy : g.vy;
+
+    switch (g.type) {
+    case GestureType::Tap: {
+      TapTouchEvent event = TapTouchEvent(start);
+      event.traceId = LatencyTracer::begin(g.downUs);
+      handler->handleEvent(event);
+      break;
+    }
+    case GestureType::DoubleTap: {
+      DoubleTapTouchEvent event = DoubleTapTouchEvent(start);
+      event.traceId = LatencyTracer::begin(g.downUs);
+      handler->handleEvent(event);
+      break;
+    }
+    case GestureType::LongPress: {
+      // the hold is deliberate, so trace from recognition, not contact
+      LongPressTouchEvent event = LongPressTouchEvent(start);
+      event.traceId = LatencyTracer::begin();
+      handler->handleEvent(event);
+      break;
+    }
+    case GestureType::Swipe: {
+      SwipeTouchEvent event = SwipeTouchEvent(swipeDirection(start, at), start);
+      event.velocityX = vx;
+      event.velocityY = vy;
+      event.traceId = LatencyTracer::begin(g.downUs);
+      handler->handleEvent(event);
+      break;
+    }
+    case GestureType::DragStart:
+    case GestureType::Drag:
+    case GestureType::DragEnd: {
+      DragPhase phase = g.type == GestureType::DragStart ? DragPhase::DragStart
+                        : g.type == GestureType::Drag    ? DragPhase::DragMove
+                                                         : DragPhase::DragEnd;
+      DragTouchEvent event = DragTouchEvent(phase, start, at);
+      event.velocityX = vx;
+      event.velocityY = vy;
+      handler->handleEvent(event);
+      break;
+    }
+    }
+  }
+}
@@ -0,0 +1,22 @@
+#ifndef _GESTURE_EVENTS_H_
+#define _GESTURE_EVENTS_H_
+
+#include "device/gesture/GestureRecognizer.h"
+#include "device/types/TouchLocation.h"
+#include "events/EventHandler.h"
+#include "events/types/InputEvent.h"
+
+// Driver-side glue for GestureRecognizer: converts recognised gestures
+// from panel to display coordinates and delivers them as TouchEvents, with
+// a latency trace opened at first contact.
+class GestureEvents {
+public:
+  // Panel coordinates → display coordinates for the current rotation
+  static TouchLocation toDisplay(int x, int y);
+
+  // Deliver every gesture the recognizer has ready
+  static void deliver(GestureRecognizer &recognizer,
+                      EventHandler<InputEvent> *handler);
+};
+
+#endif // _GESTURE_EVENTS_H_
@@ -0,0 +1,152 @@
+#include "device/gesture/GestureRecognizer.h"
+
+#include <stdlib.h>
+
+// clang-format off
+const GestureRecognizer::Transition
+    GestureRecognizer::table[StateCount][InputCount] = {
+  //               Down                         Move                    Leave                             Up                        Timeout
+  /* Idle */       {{Pressed, Begin},           {Idle, None},           {Idle, None},                     {Idle, None},             {Idle, None}},
+  /* Pressed */    {{Pressed, None},            {Pressed, None},        {Dragging, StartDrag},            {TapPending, Release},    {Held, LongPress}},
+  /* Dragging */   {{Dragging, None},           {Dragging, DragMove},   {Dragging, DragMove},             {Idle, EndDrag},          {Dragging, None}},
+  /* Held */       {{Held, None},               {Held, None},           {Held, None},                     {Idle, None},             {Held, None}},
+  /* TapPending */ {{SecondPress, BeginSecond}, {TapPending, None},     {TapPending, None},               {TapPending, None},       {Idle, FlushTap}},
+  /* SecondPress */{{SecondPress, None},        {SecondPress, None},    {Dragging, TapThenStartDrag},     {Idle, DoubleTap},        {Held, TapThenLongPress}},
+};
+// clang-format on
+
+static int16_t clampVelocity(int32_t v) {
+  if (v > INT16_MAX) return INT16_MAX;
+  if (v < -INT16_MAX) return -INT16_MAX;
+  return (int16_t)v;
+}
+
+bool GestureRecognizer::beyondSlop(const TouchSample &s) const {
+  return abs(s.x - startX) > config.tapSlop || abs(s.y - startY) > config.tapSlop;
+}
+
+void GestureRecognizer::sample(const TouchSample &s) {
+  if (s.pressed) {
+    if (state == Idle || state == TapPending) {
+      run(Down, &s);
+    } else {
+      run(beyondSlop(s) ? Leave : Move, &s);
+    }
+    return;
+  }
+  // A release may land somewhere new (recordings with only down/up, or a
+  // controller that reports the last point with the release); move there
+  // first so the drag and its velocity see it.
+  bool tracking = state == Pressed || state == Dragging || state == SecondPress;
+  if (tracking && (s.x != x || s.y != y)) {
+    TouchSample moved = s;
+    moved.pressed = true;
+    run(beyondSlop(moved) ? Leave : Move, &moved);
+  }
+  run(Up, &s);
+}
+
+void GestureRecognizer::tick(uint32_t nowMs) {
+  switch (state) {
+  case Pressed:
+  case SecondPress:
+    if (config.longPressMs > 0 && nowMs - downMs >= config.longPressMs) {
+      run(Timeout, nullptr);
+    }
+    break;
+  case TapPending:
+    if (nowMs - upMs >= config.doubleTapMs) run(Timeout, nullptr);
+    break;
+  default:
+    break;
+  }
+}
+
+void GestureRecognizer::track(const TouchSample &s) {
+  // slide the velocity anchor so it stays about one window behind
+  if (s.ms - anchorMs > GESTURE_VELOCITY_WINDOW_MS) {
+    anchorX = prevX;
+    anchorY = prevY;
+    anchorMs = prevMs;
+  }
+  prevX = s.x;
+  prevY = s.y;
+  prevMs = s.ms;
+  x = s.x;
+  y = s.y;
+}
+
+void GestureRecognizer::emit(GestureType type, int16_t vx, int16_t vy) {
+  // moves are only position updates: if the consumer falls behind, drop
+  // them rather than the release that follows
+  if (type == GestureType::Drag && pending.size() >= pending.capacity() / 2) return;
+  Gesture g = {type, startX, startY, x, y, vx, vy, downUs};
+  pending.tryPush(g);
+}
+
+void GestureRecognizer::emitTap() {
+  pending.tryPush(heldTap);
+}
+
+void GestureRecognizer::run(Input input, const TouchSample *s) {
+  const Transition &t = table[state][input];
+  state = t.next;
+
+  switch (t.action) {
+  case None:
+    break;
+  case Begin:
+  case BeginSecond:
+    startX = x = anchorX = prevX = s->x;
+    startY = y = anchorY = prevY = s->y;
+    downMs = anchorMs = prevMs = s->ms;
+    downUs = s->us;
+    break;
+  case TapThenStartDrag:
+    emitTap();
+    // fall through
+  case StartDrag:
+    track(*s);
+    emit(GestureType::DragStart);
+    break;
+  case DragMove:
+    if (s->x == x && s->y == y) break;
+    track(*s);
+    emit(GestureType::Drag);
+    break;
+  case Release:
+    upMs = s->ms;
+    heldTap = {GestureType::Tap, startX, startY, startX, startY, 0, 0, downUs};
+    if (config.doubleTapMs == 0) {
+      emitTap();
+      state = Idle;
+    }
+    break;
+  case EndDrag: {
+    uint32_t dt = s->ms - anchorMs;
+    if (dt == 0) dt = 1;
+    int32_t vx = (int32_t)(x - anchorX) * 1000 / (int32_t)dt;
+    int32_t vy = (int32_t)(y - anchorY) * 1000 / (int32_t)dt;
+    int32_t dx = x - startX, dy = y - startY;
+    int64_t minDist = config.swipeMinDistance, minVel = config.swipeMinVelocity;
+    bool far = (int64_t)dx * dx + (int64_t)dy * dy >= minDist * minDist;
+    bool fast = (int64_t)vx * vx + (int64_t)vy * vy >= minVel * minVel;
+    emit(far && fast ? GestureType::Swipe : GestureType::DragEnd,
+         clampVelocity(vx), clampVelocity(vy));
+    break;
+  }
+  case DoubleTap:
+    heldTap.type = GestureType::DoubleTap;
+    emitTap();
+    break;
+  case FlushTap:
+    emitTap();
+    break;
+  case TapThenLongPress:
+    emitTap();
+    // fall through
+  case LongPress:
+    emit(GestureType::LongPress);
+    break;
+  }
+}
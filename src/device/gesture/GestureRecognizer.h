@@ -0,0 +1,146 @@
+#ifndef _GESTURE_RECOGNIZER_H_
+#define _GESTURE_RECOGNIZER_H_
+
+#include <stdint.h>
+
+#include "BoardConfig.h"
+#include "events/RingBuffer.h"
+
+// Thresholds — override per board in BoardConfig.h
+#ifndef GESTURE_TAP_SLOP
+#define GESTURE_TAP_SLOP 10 // px of travel before a contact becomes a drag
+#endif
+#ifndef GESTURE_SWIPE_MIN_DISTANCE
+#define GESTURE_SWIPE_MIN_DISTANCE 30 // px from contact start to release
+#endif
+#ifndef GESTURE_SWIPE_MIN_VELOCITY
+#define GESTURE_SWIPE_MIN_VELOCITY 100 // px/s at release
+#endif
+#ifndef GESTURE_LONG_PRESS_MS
+#define GESTURE_LONG_PRESS_MS 600 // 0 disables long press
+#endif
+#ifndef GESTURE_DOUBLE_TAP_MS
+#define GESTURE_DOUBLE_TAP_MS 0 // 0 disables double tap, so taps aren't held back
+#endif
+
+// Release velocity is measured over roughly this much of the contact's tail
+#define GESTURE_VELOCITY_WINDOW_MS 50
+
+struct GestureConfig {
+  uint16_t tapSlop = GESTURE_TAP_SLOP;
+  uint16_t swipeMinDistance = GESTURE_SWIPE_MIN_DISTANCE;
+  uint16_t swipeMinVelocity = GESTURE_SWIPE_MIN_VELOCITY;
+  uint16_t longPressMs = GESTURE_LONG_PRESS_MS;
+  uint16_t doubleTapMs = GESTURE_DOUBLE_TAP_MS;
+};
+
+// One raw report from a touch controller, in panel coordinates. Released
+// samples carry the last known contact position.
+struct TouchSample {
+  uint32_t ms; // millis() when sampled; drives every threshold
+  uint32_t us; // micros() when sampled; only used for latency tracing
+  int16_t x, y;
+  bool pressed;
+};
+
+enum class GestureType : uint8_t {
+  Tap,
+  DoubleTap,
+  LongPress,
+  DragStart, // contact left the tap slop
+  Drag,      // contact moved while dragging
+  DragEnd,   // released too short/slow for a swipe
+  Swipe,     // released after a fast enough drag
+};
+
+struct Gesture {
+  GestureType type;
+  int16_t startX, startY; // where the contact began
+  int16_t x, y;           // current / release position
+  int16_t vx, vy;         // px/s at release (Swipe, DragEnd)
+  uint32_t downUs;        // TouchSample::us at first contact
+};
+
+// Turns raw contact samples into gestures. Table-driven state machine over
+// fixed-size state: no heap, no String, no Arduino or LVGL dependencies, so
+// it can be fed recorded traces on the host. Every touch driver owns one,
+// so thresholds and cost are the same on every board.
+//
+// Usage (from the driver's poll):
+//   recognizer.sample({millis(), micros(), x, y, pressed});
+//   recognizer.tick(millis());   // long press / double-tap timeouts
+//   Gesture g;
+//   while (recognizer.poll(g)) { ... }
+//
+class GestureRecognizer {
+public:
+  explicit GestureRecognizer(const GestureConfig &config = GestureConfig())
+      : config(config) {}
+
+  void sample(const TouchSample &s);
+  // Run time-based transitions; call every poll, even without new samples
+  void tick(uint32_t nowMs);
+  // Take the next recognised gesture; false when there are none
+  bool poll(Gesture &out) { return pending.tryPop(out); }
+
+  // Contact in progress or a tap held back for a possible double tap
+  bool active() const { return state != Idle; }
+  const GestureConfig &settings() const { return config; }
+
+private:
+  enum State : uint8_t {
+    Idle,
+    Pressed,     // down, within tap slop
+    Dragging,    // down, moved beyond tap slop
+    Held,        // long press reported; waiting for release
+    TapPending,  // released a tap, waiting for a second one
+    SecondPress, // second contact of a possible double tap
+    StateCount,
+  };
+  enum Input : uint8_t {
+    Down,    // pressed sample while no contact is tracked
+    Move,    // pressed sample within tap slop
+    Leave,   // pressed sample beyond tap slop
+    Up,      // released sample
+    Timeout, // long-press or double-tap window elapsed
+    InputCount,
+  };
+  enum Action : uint8_t {
+    None,
+    Begin,            // remember contact start
+    BeginSecond,      // second contact of a double tap
+    StartDrag,
+    TapThenStartDrag, // pending tap is a single tap after all
+    DragMove,
+    Release,          // tap, or tap held back for double-tap
+    EndDrag,          // swipe or drag end
+    DoubleTap,
+    FlushTap,         // double-tap window elapsed
+    LongPress,
+    TapThenLongPress,
+  };
+  struct Transition {
+    State next;
+    Action action;
+  };
+  static const Transition table[StateCount][InputCount];
+
+  GestureConfig config;
+  State state = Idle;
+  int16_t startX = 0, startY = 0;
+  int16_t x = 0, y = 0;
+  uint32_t downMs = 0, upMs = 0, downUs = 0;
+  // earlier sample release velocity is measured from, and the one after it
+  int16_t anchorX = 0, anchorY = 0, prevX = 0, prevY = 0;
+  uint32_t anchorMs = 0, prevMs = 0;
+  Gesture heldTap = {}; // tap waiting out the double-tap window
+  RingBuffer<Gesture, 8> pending;
+
+  void run(Input input, const TouchSample *s);
+  void track(const TouchSample &s);
+  bool beyondSlop(const TouchSample &s) const;
+  void emit(GestureType type, int16_t vx = 0, int16_t vy = 0);
+  void emitTap();
+};
+
+#endif // _GESTURE_RECOGNIZER_H_
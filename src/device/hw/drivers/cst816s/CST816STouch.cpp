@@ -1,52 +1,48 @@
 #include "device/hw/drivers/cst816s/CST816STouch.h"
-#include "BoardConfig.h"
-#include "lvgl.h"
+#include "device/gesture/GestureEvents.h"
+#include "util/WakeSignal.h"
+#ifdef TOUCH_RECORD
+#include "util/TouchRecorder.h"
+#endif
 
-static TouchLocation flipTouch(TouchLocation loc) {
-  if (lv_display_get_rotation(NULL) == LV_DISPLAY_ROTATION_180) {
-    loc.x = SCREEN_WIDTH - 1 - loc.x;
-    loc.y = SCREEN_HEIGHT - 1 - loc.y;
-  }
-  return loc;
-}
+volatile bool CST816STouch::_irqPending = false;
+volatile uint32_t CST816STouch::_irqUs = 0;
 
-static SwipeDirection flipSwipe(SwipeDirection dir) {
-  if (lv_display_get_rotation(NULL) != LV_DISPLAY_ROTATION_180) return dir;
-  switch (dir) {
-    case SwipeDirection::SwipeUp: return SwipeDirection::SwipeDown;
-    case SwipeDirection::SwipeDown: return SwipeDirection::SwipeUp;
-    case SwipeDirection::SwipeLeft: return SwipeDirection::SwipeRight;
-    case SwipeDirection::SwipeRight: return SwipeDirection::SwipeLeft;
-    default: return dir;
-  }
+// No I2C from interrupt context: note the report and wake the loop
+void IRAM_ATTR CST816STouch::onInterrupt() {
+  if (!_irqPending) _irqUs = micros();
+  _irqPending = true;
+  WakeSignal::notifyFromISR();
 }
 
 void CST816STouch::pollEvent(EventHandler<InputEvent> *handler) {
-  if (!available()) {
-    return;
-  }
-  String gesture = this->gesture();
-  if (gesture == "SINGLE CLICK") {
-    TapTouchEvent event = TapTouchEvent(flipTouch(location()));
-    handler->handleEvent(event);
-    return;
+  // keep reading while a finger is down so a missed edge can't leave the
+  // pointer stuck pressed
+  if (_irqPending || _pressed) readPoint();
+  _gestures.tick(millis());
+  GestureEvents::deliver(_gestures, handler);
+}
+
+void CST816STouch::readPoint() {
+  uint32_t reportUs = _irqPending ? _irqUs : micros();
+  _irqPending = false;
+
+  uint8_t raw[6];
+  bool pressed = false;
+  if (readRegs(CST816S_REG_DATA, raw, sizeof(raw))) {
+    pressed = raw[1] > 0;
   }
-  if (gesture == "SWIPE UP" || gesture == "SWIPE DOWN" ||
-      gesture == "SWIPE LEFT" || gesture == "SWIPE RIGHT") {
-    SwipeDirection direction = SwipeDirection::UnknownDirection;
-    // swap down and up to match hardware
-    if (gesture == "SWIPE UP") {
-      direction = SwipeDirection::SwipeDown;
-    } else if (gesture == "SWIPE DOWN") {
-      direction = SwipeDirection::SwipeUp;
-    } else if (gesture == "SWIPE LEFT") {
-      direction = SwipeDirection::SwipeLeft;
-    } else if (gesture == "SWIPE RIGHT") {
-      direction = SwipeDirection::SwipeRight;
-    }
-    direction = flipSwipe(direction);
-    SwipeTouchEvent event = SwipeTouchEvent(direction, flipTouch(location()));
-    handler->handleEvent(event);
-    return;
+  if (pressed) {
+    _lastPos = {((raw[2] & 0x0F) << 8) | raw[3], ((raw[4] & 0x0F) << 8) | raw[5]};
   }
+  if (!pressed && !_pressed) return;
+
+#ifdef TOUCH_RECORD
+  TouchLocation loc = GestureEvents::toDisplay(_lastPos.x, _lastPos.y);
+  if (pressed && !_pressed) TouchRecorder::down(loc.x, loc.y);
+  if (!pressed && _pressed) TouchRecorder::up(loc.x, loc.y);
+#endif
+  _pressed = pressed;
+  _gestures.sample({(uint32_t)millis(), reportUs, (int16_t)_lastPos.x,
+                    (int16_t)_lastPos.y, pressed});
 }
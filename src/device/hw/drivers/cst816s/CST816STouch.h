@@ -1,33 +1,89 @@
 #ifndef _CST816S_TOUCH_H_
 #define _CST816S_TOUCH_H_
 
-#include <CST816S.h>
+#include <Arduino.h>
+#include <Wire.h>
 
 #include "BoardConfig.h"
 #include "device/ITouch.h"
+#include "device/gesture/GestureRecognizer.h"
 #include "device/types/TouchLocation.h"
 #include "events/types/TouchEvent.h"
 
-class CST816STouch : public ITouch {
-private:
-  CST816S *driver = nullptr;
+#define CST816S_ADDR 0x15
+
+// CST816S registers
+#define CST816S_REG_DATA 0x01 // gesture id, finger count, XH, XL, YH, YL
+#define CST816S_REG_VERSION 0x15
+#define CST816S_REG_IRQ_CTL 0xFA
+
+// CST816S_REG_IRQ_CTL bits
+#define CST816S_IRQ_EN_TOUCH 0x40  // periodic reports while touched
+#define CST816S_IRQ_EN_CHANGE 0x20 // touch state changes
 
+// Talks to the controller directly over Wire. The controller raises IRQ
+// for every report while touched; the ISR only flags it and wakes the
+// loop, and pollEvent does the I2C read, so an idle screen costs nothing.
+// The controller's own gesture id is ignored: samples go through the
+// shared GestureRecognizer like every other board.
+class CST816STouch : public ITouch {
 public:
   CST816STouch() {}
-  ~CST816STouch() { delete driver; }
 
   void init() override {
-    driver = new CST816S(TOUCH_SDA, TOUCH_SCL, TOUCH_RST, TOUCH_INT);
-    driver->begin();
+    Wire.begin(TOUCH_SDA, TOUCH_SCL);
+    pinMode(TOUCH_INT, INPUT);
+    pinMode(TOUCH_RST, OUTPUT);
+    digitalWrite(TOUCH_RST, HIGH);
+    delay(50);
+    digitalWrite(TOUCH_RST, LOW);
+    delay(5);
+    digitalWrite(TOUCH_RST, HIGH);
+    delay(50);
+    uint8_t version = 0;
+    readRegs(CST816S_REG_VERSION, &version, 1);
+    Serial.printf("[CST816S] firmware version %u\n", version);
+    writeReg(CST816S_REG_IRQ_CTL, CST816S_IRQ_EN_TOUCH | CST816S_IRQ_EN_CHANGE);
+    attachInterrupt(digitalPinToInterrupt(TOUCH_INT), onInterrupt, RISING);
   }
 
   void pollEvent(EventHandler<InputEvent> *handler) override;
 
+  bool pointer(TouchLocation &location) override {
+    location = _lastPos;
+    return _pressed;
+  }
+
+  bool gesturesPending() override { return _gestures.active(); }
+
 private:
-  bool available() { return driver->available(); }
-  String gesture() { return driver->gesture(); }
-  TouchLocation location() {
-    return {driver->data.x, driver->data.y};
+  // set by the ISR, consumed by pollEvent
+  static volatile bool _irqPending;
+  static volatile uint32_t _irqUs;
+  static void IRAM_ATTR onInterrupt();
+
+  bool _pressed = false;
+  TouchLocation _lastPos = {};
+  GestureRecognizer _gestures;
+
+  void readPoint();
+
+  void writeReg(uint8_t reg, uint8_t val) {
+    Wire.beginTransmission(CST816S_ADDR);
+    Wire.write(reg);
+    Wire.write(val);
+    Wire.endTransmission();
+  }
+
+  bool readRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+    Wire.beginTransmission(CST816S_ADDR);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom((uint8_t)CST816S_ADDR, len) != len) return false;
+    for (uint8_t i = 0; i < len; i++) {
+      buf[i] = Wire.read();
+    }
+    return true;
   }
 };
 
@@ -1,32 +1,33 @@
 #include "device/hw/drivers/gt911/GT911Touch.h"
-#include "BoardConfig.h"
-#include "lvgl.h"
+#include "device/gesture/GestureEvents.h"
+#include "util/WakeSignal.h"
+#ifdef TOUCH_RECORD
+#include "util/TouchRecorder.h"
+#endif
 
-#include <cmath>
+volatile bool GT911Touch::_irqPending = false;
+volatile uint32_t GT911Touch::_irqUs = 0;
 
-// Swipe detection thresholds
-#define SWIPE_MIN_DISTANCE 50
-
-static TouchLocation flipTouch(TouchLocation loc) {
-  if (lv_display_get_rotation(NULL) == LV_DISPLAY_ROTATION_180) {
-    loc.x = SCREEN_WIDTH - 1 - loc.x;
-    loc.y = SCREEN_HEIGHT - 1 - loc.y;
-  }
-  return loc;
+// No I2C from interrupt context: note the report and wake the loop,
+// which reads the point registers on its next pass.
+void IRAM_ATTR GT911Touch::onInterrupt() {
+  if (!_irqPending) _irqUs = micros();
+  _irqPending = true;
+  WakeSignal::notifyFromISR();
 }
 
-static SwipeDirection flipSwipe(SwipeDirection dir) {
-  if (lv_display_get_rotation(NULL) != LV_DISPLAY_ROTATION_180) return dir;
-  switch (dir) {
-    case SwipeDirection::SwipeUp: return SwipeDirection::SwipeDown;
-    case SwipeDirection::SwipeDown: return SwipeDirection::SwipeUp;
-    case SwipeDirection::SwipeLeft: return SwipeDirection::SwipeRight;
-    case SwipeDirection::SwipeRight: return SwipeDirection::SwipeLeft;
-    default: return dir;
-  }
+void GT911Touch::pollEvent(EventHandler<InputEvent> *handler) {
+  // Idle screen: no report pending, no bus traffic. While a finger is down
+  // keep reading every pass so a missed edge can't swallow the release.
+  if (_irqPending || _wasTouched) readPoint();
+  _gestures.tick(millis());
+  GestureEvents::deliver(_gestures, handler);
 }
 
-void GT911Touch::pollEvent(EventHandler<InputEvent> *handler) {
+void GT911Touch::readPoint() {
+  uint32_t reportUs = _irqPending ? _irqUs : micros();
+  _irqPending = false;
+
   uint8_t status = readReg(GT911_REG_STATUS);
   uint8_t touchCount = status & 0x0F;
   bool bufferReady = status & 0x80;
@@ -45,30 +46,22 @@ void GT911Touch::pollEvent(EventHandler<InputEvent> *handler) {
     uint16_t y = buf[3] | (buf[4] << 8);
 
     _lastPos = {(int)x, (int)y};
+#ifdef TOUCH_RECORD
     if (!_wasTouched) {
-      _wasTouched = true;
-      _touchStart = _lastPos;
+      TouchLocation loc = GestureEvents::toDisplay(x, y);
+      TouchRecorder::down(loc.x, loc.y);
     }
+#endif
+    _wasTouched = true;
   } else if (_wasTouched) {
     _wasTouched = false;
-
-    int dx = _lastPos.x - _touchStart.x;
-    int dy = _lastPos.y - _touchStart.y;
-    int dist = (int)sqrt(dx * dx + dy * dy);
-
-    if (dist < SWIPE_MIN_DISTANCE) {
-      TapTouchEvent event = TapTouchEvent(flipTouch(_touchStart));
-      handler->handleEvent(event);
-    } else {
-      SwipeDirection dir;
-      if (abs(dx) > abs(dy)) {
-        dir = dx > 0 ? SwipeDirection::SwipeRight : SwipeDirection::SwipeLeft;
-      } else {
-        dir = dy > 0 ? SwipeDirection::SwipeDown : SwipeDirection::SwipeUp;
-      }
-      dir = flipSwipe(dir);
-      SwipeTouchEvent event = SwipeTouchEvent(dir, flipTouch(_touchStart));
-      handler->handleEvent(event);
-    }
+#ifdef TOUCH_RECORD
+    TouchLocation upLoc = GestureEvents::toDisplay(_lastPos.x, _lastPos.y);
+    TouchRecorder::up(upLoc.x, upLoc.y);
+#endif
+  } else {
+    return;
   }
+  _gestures.sample({(uint32_t)millis(), reportUs, (int16_t)_lastPos.x,
+                    (int16_t)_lastPos.y, _wasTouched});
 }
@@ -6,6 +6,7 @@
 
 #include "BoardConfig.h"
 #include "device/ITouch.h"
+#include "device/gesture/GestureRecognizer.h"
 #include "device/types/TouchLocation.h"
 #include "events/types/TouchEvent.h"
 
@@ -22,14 +23,31 @@ public:
 
   void init() override {
     writeReg(GT911_REG_STATUS, 0);
+    // INT pulses once per report frame; the trigger edge depends on the
+    // module's config (0x804D), so take either edge
+    attachInterrupt(digitalPinToInterrupt(TOUCH_INT), onInterrupt, CHANGE);
   }
 
   void pollEvent(EventHandler<InputEvent> *handler) override;
 
+  bool pointer(TouchLocation &location) override {
+    location = _lastPos;
+    return _wasTouched;
+  }
+
+  bool gesturesPending() override { return _gestures.active(); }
+
 private:
+  // set by the ISR, consumed by pollEvent
+  static volatile bool _irqPending;
+  static volatile uint32_t _irqUs;
+  static void IRAM_ATTR onInterrupt();
+
   bool _wasTouched = false;
-  TouchLocation _touchStart = {};
   TouchLocation _lastPos = {};
+  GestureRecognizer _gestures;
+
+  void readPoint();
 
   void writeReg(uint16_t reg, uint8_t val) {
     Wire.beginTransmission(GT911_ADDR);
@@ -5,6 +5,8 @@
 #include <Arduino.h>
 
 #include "config/NetworkConfig.h"
+#include "device/hw/drivers/network/ArduinoSocket.h"
+#include "util/AllocTracker.h"
 
 void ArduinoNetwork::init() {
   WiFi.mode(WIFI_STA);
@@ -30,56 +32,264 @@ bool ArduinoNetwork::isConnected() {
   return WiFi.status() == WL_CONNECTED;
 }
 
-HttpResponse ArduinoNetwork::get(const char *url, const char *authHeader,
-                                 const char *ifNoneMatch) {
-  HttpResponse response;
-  if (!isConnected()) return response;
+std::unique_ptr<ISocket> ArduinoNetwork::createSocket() {
+  return std::unique_ptr<ISocket>(new ArduinoSocket());
+}
+
+// "http://host:port/path" -> "http://host:port"
+static String originOf(const String &url) {
+  int scheme = url.indexOf("://");
+  int path = url.indexOf('/', scheme < 0 ? 0 : scheme + 3);
+  return path < 0 ? url : url.substring(0, path);
+}
+
+// Errors a reused socket gives when the server closed it while it sat
+// idle. A POST is only retried if the server can't have acted on it.
+static bool staleConnection(int code, HttpRequest::Method method) {
+  if (code == HTTPC_ERROR_SEND_HEADER_FAILED ||
+      code == HTTPC_ERROR_SEND_PAYLOAD_FAILED) {
+    return true;
+  }
+  return method == HttpRequest::Method::Get &&
+         (code == HTTPC_ERROR_CONNECTION_LOST ||
+          code == HTTPC_ERROR_NOT_CONNECTED);
+}
+
+ArduinoNetwork::Connection *ArduinoNetwork::acquire(const String &origin,
+                                                    bool fresh, bool &reused) {
+  std::lock_guard<std::mutex> lock(_poolMutex);
+  unsigned long now = millis();
+  // drop idle sockets past their timeout or already closed by the server
+  for (auto it = _pool.begin(); it != _pool.end();) {
+    Connection *c = it->get();
+    if (!c->busy && (now - c->lastUsed >= ARDUINO_NETWORK_IDLE_TIMEOUT_MS ||
+                     !c->client.connected())) {
+      it = _pool.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto &c : _pool) {
+    if (!fresh && !c->busy && c->origin == origin) {
+      c->busy = true;
+      reused = true;
+      return c.get();
+    }
+  }
+  // full: make room by closing the least recently used idle socket
+  if (_pool.size() >= ARDUINO_NETWORK_MAX_CONNECTIONS) {
+    auto oldest = _pool.end();
+    for (auto it = _pool.begin(); it != _pool.end(); ++it) {
+      if ((*it)->busy) continue;
+      if (oldest == _pool.end() || (long)((*it)->lastUsed - (*oldest)->lastUsed) < 0) {
+        oldest = it;
+      }
+    }
+    if (oldest != _pool.end()) _pool.erase(oldest);
+  }
+  auto conn = std::make_unique<Connection>();
+  conn->origin = origin;
+  conn->busy = true;
+  conn->http.setReuse(true);
+  reused = false;
+  _pool.push_back(std::move(conn));
+  return _pool.back().get();
+}
+
+void ArduinoNetwork::release(Connection *conn) {
+  std::lock_guard<std::mutex> lock(_poolMutex);
+  if (conn->client.connected()) {
+    conn->busy = false;
+    conn->lastUsed = millis();
+    return;
+  }
+  for (auto it = _pool.begin(); it != _pool.end(); ++it) {
+    if (it->get() == conn) {
+      _pool.erase(it);
+      return;
+    }
+  }
+}
+
+// A Content-Length body straight off the socket, read through a small
+// buffer: ArduinoJson reads a byte at a time, and a timed read per byte
+// would be slow. Never reads past the body, so the socket can carry the
+// next response.
+class SocketBodyStream : public BodyStream {
+  Stream &_stream;
+  int _remaining;
+  bool _failed = false;
+  char _buf[256];
+  size_t _pos = 0;
+  size_t _len = 0;
+
+  bool fill() {
+    if (_remaining <= 0 || _failed) return false;
+    size_t want = min((size_t)_remaining, sizeof(_buf));
+    size_t got = _stream.readBytes(_buf, want); // waits up to the read timeout
+    _remaining -= got;
+    _pos = 0;
+    _len = got;
+    if (got < want) _failed = true;
+    return got > 0;
+  }
+
+public:
+  SocketBodyStream(Stream &stream, int length)
+      : _stream(stream), _remaining(length) {}
+
+  int read() override {
+    if (_pos == _len && !fill()) return -1;
+    return (uint8_t)_buf[_pos++];
+  }
+  size_t readBytes(char *buf, size_t len) override {
+    size_t n = 0;
+    while (n < len) {
+      if (_pos == _len && !fill()) break;
+      size_t chunk = min(len - n, _len - _pos);
+      memcpy(buf + n, _buf + _pos, chunk);
+      _pos += chunk;
+      n += chunk;
+    }
+    return n;
+  }
+  // Skip what the reader left; false if the body never arrived in full
+  bool finish() {
+    while (fill()) {
+    }
+    return !_failed;
+  }
+};
+
+// Chunked bodies, decoded by HTTPClient::writeToStream() straight into
+// the response buffer. Refusing a write (past RESPONSE_BUFFER_MAX) makes
+// writeToStream() give up.
+class ResponseSink : public Stream {
+  ResponseBuffer &_body;
+
+public:
+  bool overflowed = false;
+
+  explicit ResponseSink(ResponseBuffer &body) : _body(body) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override {
+    if (_body.append((const char *)buf, len)) return len;
+    overflowed = true;
+    return 0;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+// The body into response.body, read off the socket into a pooled block
+// rather than through a growing String. False if it didn't arrive whole
+// (statusCode then says why), leaving the socket unfit for reuse.
+static bool readBody(HTTPClient &http, HttpResponse &response) {
+  int size = http.getSize();
+  if (size < 0) {
+    ResponseSink sink(response.body);
+    if (http.writeToStream(&sink) >= 0) return true;
+    response.statusCode =
+        sink.overflowed ? HTTP_ERROR_TOO_LARGE : HTTP_ERROR_FAILED;
+  } else if (response.body.reserve(size)) {
+    size_t n = http.getStream().readBytes(response.body.tail(), size);
+    response.body.commit(n);
+    if (n == (size_t)size) return true;
+    response.statusCode = HTTP_ERROR_FAILED;
+  } else {
+    response.statusCode = size > RESPONSE_BUFFER_MAX ? HTTP_ERROR_TOO_LARGE
+                                                     : HTTP_ERROR_FAILED;
+  }
+  if (response.statusCode == HTTP_ERROR_TOO_LARGE) {
+    Serial.printf("[Network] body over %u bytes, dropped\n",
+                  (unsigned)RESPONSE_BUFFER_MAX);
+  }
+  response.body.reset();
+  return false;
+}
+
+// One request over conn; returns HTTPClient's code, which is negative on
+// a transport error. end() leaves the socket open if the server agreed.
+int ArduinoNetwork::send(Connection *conn, const HttpRequest &req,
+                         uint32_t timeoutMs, HttpResponse &response) {
+  // HTTPClient's timeouts are per phase; a deadline caps each of them
+  uint32_t connectMs = ARDUINO_NETWORK_CONNECT_TIMEOUT_MS;
+  uint32_t readMs = ARDUINO_NETWORK_READ_TIMEOUT_MS;
+  if (timeoutMs > 0) {
+    connectMs = min(connectMs, timeoutMs);
+    readMs = min(readMs, timeoutMs);
+  }
 
-  HTTPClient http;
-  http.setConnectTimeout(3000);
-  http.setTimeout(5000);
-  http.begin(url);
+  HTTPClient &http = conn->http;
+  http.setConnectTimeout(connectMs);
+  http.setTimeout(readMs);
+  http.begin(conn->client, req.url);
   const char *collectHdrs[] = {"ETag"};
   http.collectHeaders(collectHdrs, 1);
-  if (authHeader) {
-    http.addHeader("Authorization", authHeader);
-  }
-  if (ifNoneMatch) {
-    http.addHeader("If-None-Match", ifNoneMatch);
+  if (req.authHeader.length() > 0) {
+    http.addHeader("Authorization", req.authHeader);
   }
 
-  response.statusCode = http.GET();
-  if (response.statusCode > 0) {
-    if (response.statusCode != 304) {
-      response.body = http.getString();
+  int code;
+  if (req.method == HttpRequest::Method::Post) {
+    http.addHeader("Content-Type", req.contentType);
+    code = http.POST(req.body);
+  } else {
+    if (req.ifNoneMatch.length() > 0) {
+      http.addHeader("If-None-Match", req.ifNoneMatch);
     }
+    code = http.GET();
+  }
+  if (code > 0) {
+    response.statusCode = code;
     if (http.hasHeader("ETag")) {
       response.etag = http.header("ETag");
     }
+    if (code == 200 && req.onBody && http.getSize() >= 0) {
+      SocketBodyStream body(http.getStream(), http.getSize());
+      req.onBody(body);
+      // a half-read body would be taken for the next response
+      if (!body.finish()) conn->client.stop();
+    } else if (code != 304) {
+      // chunked bodies are buffered: HTTPClient only decodes them whole
+      if (readBody(http, response)) {
+        INetwork::streamBuffered(req, response);
+      } else {
+        conn->client.stop();
+      }
+    }
   }
   http.end();
-  return response;
+  return code;
 }
 
-HttpResponse ArduinoNetwork::post(const char *url, const char *body,
-                                  const char *contentType,
-                                  const char *authHeader) {
+HttpResponse ArduinoNetwork::perform(const HttpRequest &req,
+                                     uint32_t timeoutMs) {
+  AllocScope scope(AllocPhase::Network);
   HttpResponse response;
   if (!isConnected()) return response;
 
-  HTTPClient http;
-  http.setConnectTimeout(3000);
-  http.setTimeout(5000);
-  http.begin(url);
-  http.addHeader("Content-Type", contentType);
-  if (authHeader) {
-    http.addHeader("Authorization", authHeader);
-  }
+  String origin = originOf(req.url);
+  unsigned long start = millis();
+  bool reused = false;
+  Connection *conn = acquire(origin, false, reused);
+  int code = send(conn, req, timeoutMs, response);
+  release(conn);
 
-  response.statusCode = http.POST(body);
-  if (response.statusCode > 0) {
-    response.body = http.getString();
+  uint32_t elapsed = millis() - start;
+  if (code < 0 && reused && staleConnection(code, req.method) &&
+      (timeoutMs == 0 || elapsed < timeoutMs)) {
+    conn = acquire(origin, true, reused);
+    code = send(conn, req, timeoutMs > 0 ? timeoutMs - elapsed : 0, response);
+    release(conn);
+  }
+  if (code < 0) {
+    // HTTPClient's negative codes overlap ours; log it and report a failure
+    Serial.printf("[Network] %s: %s\n", req.url.c_str(),
+                  HTTPClient::errorToString(code).c_str());
+    response.statusCode = HTTP_ERROR_FAILED;
   }
-  http.end();
   return response;
 }
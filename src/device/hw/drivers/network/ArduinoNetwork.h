@@ -1,18 +1,65 @@
 #ifndef _ARDUINO_NETWORK_H_
 #define _ARDUINO_NETWORK_H_
 
-#include "device/INetwork.h"
+#include <HTTPClient.h>
+#include <WiFiClient.h>
 
-class ArduinoNetwork : public INetwork {
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "device/network/PooledNetwork.h"
+
+// Default HTTPClient timeouts, for requests without a deadline
+#define ARDUINO_NETWORK_CONNECT_TIMEOUT_MS 3000
+#define ARDUINO_NETWORK_READ_TIMEOUT_MS 5000
+
+// Close a kept-alive socket after this long unused. Just under uvicorn's
+// 5 s keep-alive, so the control server never closes one we are about to
+// reuse; Home Assistant keeps them for longer.
+#ifndef ARDUINO_NETWORK_IDLE_TIMEOUT_MS
+#define ARDUINO_NETWORK_IDLE_TIMEOUT_MS 4000
+#endif
+// Open sockets across all hosts; each holds lwIP buffers. At most
+// NETWORK_WORKERS are in use at once, so this leaves room for two hosts.
+#ifndef ARDUINO_NETWORK_MAX_CONNECTIONS
+#define ARDUINO_NETWORK_MAX_CONNECTIONS (NETWORK_WORKERS * 2)
+#endif
+
+// Wi-Fi plus HTTP/1.1 keep-alive on the PooledNetwork workers. Sockets are
+// pooled per host ("http://host:port"): a worker borrows an idle one for
+// the request's host, or opens one, and returns it if the server kept it
+// open. A request that fails on a reused socket (closed by the server
+// while idle) is retried once on a fresh connection.
+class ArduinoNetwork : public PooledNetwork {
 public:
+  ~ArduinoNetwork() override { stopWorkers(); }
+
   void init() override;
   bool isConnected() override;
-  HttpResponse get(const char *url,
-                   const char *authHeader = nullptr,
-                   const char *ifNoneMatch = nullptr) override;
-  HttpResponse post(const char *url, const char *body,
-                    const char *contentType = "application/json",
-                    const char *authHeader = nullptr) override;
+  std::unique_ptr<ISocket> createSocket() override;
+
+protected:
+  HttpResponse perform(const HttpRequest &req, uint32_t timeoutMs) override;
+
+private:
+  // HTTPClient stops its client when destroyed, so the pair lives together
+  struct Connection {
+    String origin;
+    WiFiClient client;
+    HTTPClient http;
+    unsigned long lastUsed = 0;
+    bool busy = false;
+  };
+
+  std::mutex _poolMutex;
+  std::vector<std::unique_ptr<Connection>> _pool;
+
+  // an idle socket to origin, or a new one (always, if fresh)
+  Connection *acquire(const String &origin, bool fresh, bool &reused);
+  void release(Connection *conn);
+  int send(Connection *conn, const HttpRequest &req, uint32_t timeoutMs,
+           HttpResponse &response);
 };
 
 #endif // _ARDUINO_NETWORK_H_
@@ -0,0 +1,38 @@
+#include "device/hw/drivers/network/ArduinoSocket.h"
+
+#include <Arduino.h>
+#include <lwip/sockets.h>
+
+bool ArduinoSocket::connect(const char *host, uint16_t port,
+                            uint32_t timeoutMs) {
+  close();
+  return _client.connect(host, port, (int32_t)timeoutMs) != 0;
+}
+
+bool ArduinoSocket::connected() { return _client.connected(); }
+
+int ArduinoSocket::read(uint8_t *buf, size_t len, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (_client.available() == 0) {
+    if (!_client.connected()) return -1;
+    uint32_t elapsed = millis() - start;
+    if (elapsed >= timeoutMs) return 0;
+    // sleep until data (or a FIN) arrives, or the timeout
+    int fd = _client.fd();
+    if (fd < 0) return -1;
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(fd, &readable);
+    uint32_t waitMs = timeoutMs - elapsed;
+    struct timeval tv = {(time_t)(waitMs / 1000), (suseconds_t)((waitMs % 1000) * 1000)};
+    if (select(fd + 1, &readable, nullptr, nullptr, &tv) < 0) return -1;
+  }
+  int n = _client.read(buf, len);
+  return n < 0 ? -1 : n;
+}
+
+bool ArduinoSocket::write(const uint8_t *data, size_t len) {
+  return _client.write(data, len) == len;
+}
+
+void ArduinoSocket::close() { _client.stop(); }
@@ -0,0 +1,22 @@
+#ifndef _ARDUINO_SOCKET_H_
+#define _ARDUINO_SOCKET_H_
+
+#include <WiFiClient.h>
+
+#include "device/ISocket.h"
+
+// ISocket over a WiFiClient; reads wait in select() instead of polling
+class ArduinoSocket : public ISocket {
+  WiFiClient _client;
+
+public:
+  ~ArduinoSocket() override { close(); }
+
+  bool connect(const char *host, uint16_t port, uint32_t timeoutMs) override;
+  bool connected() override;
+  int read(uint8_t *buf, size_t len, uint32_t timeoutMs) override;
+  bool write(const uint8_t *data, size_t len) override;
+  void close() override;
+};
+
+#endif // _ARDUINO_SOCKET_H_
@@ -0,0 +1,40 @@
+#ifndef _BODY_STREAM_H_
+#define _BODY_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// A response body read as it arrives (see HttpRequest::onBody). It has
+// the read()/readBytes() pair ArduinoJson takes as a custom reader, so
+// deserializeJson() can parse straight off it.
+class BodyStream {
+public:
+  virtual ~BodyStream() = default;
+
+  // The next byte, or -1 at the end of the body (or a read timeout)
+  virtual int read() = 0;
+  // Up to len bytes; fewer only at the end of the body
+  virtual size_t readBytes(char *buf, size_t len) = 0;
+};
+
+// Over a body that was received whole: the simulator's drivers, and
+// chunked responses on the device
+class BufferedBodyStream : public BodyStream {
+  const char *_data;
+  size_t _len;
+  size_t _pos = 0;
+
+public:
+  BufferedBodyStream(const char *data, size_t len) : _data(data), _len(len) {}
+
+  int read() override { return _pos < _len ? (uint8_t)_data[_pos++] : -1; }
+  size_t readBytes(char *buf, size_t len) override {
+    if (len > _len - _pos) len = _len - _pos;
+    memcpy(buf, _data + _pos, len);
+    _pos += len;
+    return len;
+  }
+};
+
+#endif // _BODY_STREAM_H_
@@ -0,0 +1,95 @@
+#include "device/network/PooledNetwork.h"
+
+#ifndef BOARD_SIMULATOR
+#include <esp_pthread.h>
+#endif
+
+PooledNetwork::~PooledNetwork() { stopWorkers(); }
+
+void PooledNetwork::request(HttpRequest req, HttpCallback onDone) {
+#ifdef SIM_HEADLESS
+  PendingRequest pending;
+  pending.deadline = millis() + req.timeoutMs;
+  pending.req = std::move(req);
+  pending.onDone = std::move(onDone);
+  run(pending);
+#else
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_stopping) {
+      if (_workers.empty()) startWorkers();
+      _queue.push(std::move(req), std::move(onDone));
+      onDone = nullptr;
+    }
+  }
+  if (onDone) {
+    HttpResponse failed;
+    onDone(failed);
+    return;
+  }
+  _ready.notify_one();
+#endif
+}
+
+void PooledNetwork::run(PendingRequest &pending) {
+  HttpResponse response;
+  unsigned long now = millis();
+  if (pending.expired(now)) {
+    response.statusCode = HTTP_ERROR_DEADLINE;
+  } else {
+    response = perform(pending.req, pending.remaining(now, 0));
+    if (response.statusCode < 0 && pending.expired(millis())) {
+      response.statusCode = HTTP_ERROR_DEADLINE;
+    }
+  }
+  pending.onDone(response);
+}
+
+// called with _mutex held
+void PooledNetwork::startWorkers() {
+#ifndef BOARD_SIMULATOR
+  esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+  cfg.stack_size = NETWORK_WORKER_STACK;
+  cfg.pin_to_core = NETWORK_WORKER_CORE;
+  cfg.thread_name = "net";
+  esp_pthread_set_cfg(&cfg);
+#endif
+  for (int i = 0; i < NETWORK_WORKERS; i++) {
+    _workers.emplace_back(&PooledNetwork::workerMain, this);
+  }
+#ifndef BOARD_SIMULATOR
+  cfg = esp_pthread_get_default_config();
+  esp_pthread_set_cfg(&cfg);
+#endif
+}
+
+void PooledNetwork::workerMain() {
+  for (;;) {
+    PendingRequest pending;
+    bool stopping;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _ready.wait(lock, [this] { return _stopping || !_queue.empty(); });
+      if (!_queue.pop(pending)) return; // stopping and drained
+      stopping = _stopping;
+    }
+    if (stopping) {
+      // fail what is left rather than perform it, but still answer it
+      HttpResponse failed;
+      pending.onDone(failed);
+      continue;
+    }
+    run(pending);
+  }
+}
+
+void PooledNetwork::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopping) return;
+    _stopping = true;
+  }
+  _ready.notify_all();
+  for (std::thread &worker : _workers) worker.join();
+  _workers.clear();
+}
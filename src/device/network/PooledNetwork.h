@@ -0,0 +1,59 @@
+#ifndef _POOLED_NETWORK_H_
+#define _POOLED_NETWORK_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "device/INetwork.h"
+#include "device/network/RequestQueue.h"
+
+// Worker threads behind INetwork::request(). Two by default: one slow
+// endpoint can't hold up everything else, and each worker's HTTP client
+// and stack stay affordable on the ESP32.
+#ifndef NETWORK_WORKERS
+#define NETWORK_WORKERS 2
+#endif
+#ifndef NETWORK_WORKER_STACK
+#define NETWORK_WORKER_STACK 8192
+#endif
+// Same core as the service worker and the Wi-Fi stack, away from the UI
+#ifndef NETWORK_WORKER_CORE
+#define NETWORK_WORKER_CORE 0
+#endif
+
+// INetwork over a bounded pool of blocking workers. Drivers only implement
+// perform(), one synchronous request on the calling worker; queueing,
+// priorities and deadlines live here. Workers start on the first request.
+//
+// Headless simulator builds have no workers: request() performs inline, so
+// runs stay deterministic on the virtual clock.
+class PooledNetwork : public INetwork {
+public:
+  ~PooledNetwork() override;
+
+  void request(HttpRequest req, HttpCallback onDone) override;
+
+protected:
+  // One request, giving up after about timeoutMs (0: the driver's default).
+  // Runs on a worker, concurrently with the other workers.
+  virtual HttpResponse perform(const HttpRequest &req, uint32_t timeoutMs) = 0;
+
+  // Drain and join the workers. Derived destructors must call this first,
+  // so no worker is inside perform() while the driver is torn down.
+  void stopWorkers();
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _ready;
+  RequestQueue _queue;
+  std::vector<std::thread> _workers;
+  bool _stopping = false;
+
+  void startWorkers();
+  void workerMain();
+  void run(PendingRequest &pending);
+};
+
+#endif // _POOLED_NETWORK_H_
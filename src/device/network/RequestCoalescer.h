@@ -0,0 +1,93 @@
+#ifndef _REQUEST_COALESCER_H_
+#define _REQUEST_COALESCER_H_
+
+#include <Arduino.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "device/INetwork.h"
+
+// Merges concurrent identical GETs. The first caller for a URL sends the
+// request; callers arriving while it is in flight join it instead, and
+// every one of them gets the same parsed result. Nothing is kept once the
+// request completes; a caller that knows the resource just changed (a
+// service call) calls forget() so later callers don't join a request
+// sent before the change.
+//
+// parse() runs once, on the network thread; the waiters are then called
+// there too, in arrival order. The joined request keeps the first caller's
+// priority and deadline. With parseBody, a 200 body is parsed as it
+// arrives (see HttpRequest::onBody) and parse() only sees other statuses.
+template <typename T>
+class RequestCoalescer {
+public:
+  using Parse = std::function<T(HttpResponse &)>;
+  using ParseBody = std::function<T(BodyStream &)>;
+  using Done = std::function<void(const std::shared_ptr<const T> &)>;
+
+  void request(INetwork *net, HttpRequest req, Parse parse, Done onDone) {
+    request(net, std::move(req), nullptr, std::move(parse), std::move(onDone));
+  }
+
+  void request(INetwork *net, HttpRequest req, ParseBody parseBody, Parse parse,
+               Done onDone) {
+    String key = req.url;
+    std::shared_ptr<std::vector<Done>> waiting;
+    {
+      std::lock_guard<std::mutex> lock(_state->mutex);
+      std::shared_ptr<std::vector<Done>> &slot = _state->inFlight[key];
+      if (slot) {
+        slot->push_back(std::move(onDone)); // joined the request already out
+        return;
+      }
+      slot = std::make_shared<std::vector<Done>>();
+      slot->push_back(std::move(onDone));
+      waiting = slot;
+    }
+    // onBody runs just before the callback, on the same thread
+    auto streamed = std::make_shared<std::shared_ptr<const T>>();
+    if (parseBody) {
+      req.onBody = [streamed, parseBody = std::move(parseBody)](BodyStream &body) {
+        *streamed = std::make_shared<const T>(parseBody(body));
+      };
+    }
+    // the callback may outlive us (network teardown), so it holds the state
+    std::shared_ptr<State> state = _state;
+    net->request(std::move(req), [state, key, waiting, streamed,
+                                  parse = std::move(parse)](HttpResponse &resp) {
+      std::shared_ptr<const T> result =
+          *streamed ? *streamed : std::make_shared<const T>(parse(resp));
+      std::vector<Done> waiters;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->inFlight.find(key);
+        // forget() may have handed the URL to a newer request already
+        if (it != state->inFlight.end() && it->second == waiting) {
+          state->inFlight.erase(it);
+        }
+        waiters = std::move(*waiting);
+      }
+      for (Done &done : waiters) done(result);
+    });
+  }
+
+  // The next request for url goes out on its own instead of joining one
+  // in flight; that one still answers the callers it already has
+  void forget(const String &url) {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    _state->inFlight.erase(url);
+  }
+
+private:
+  struct State {
+    std::mutex mutex;
+    std::map<String, std::shared_ptr<std::vector<Done>>> inFlight;
+  };
+  std::shared_ptr<State> _state = std::make_shared<State>();
+};
+
+#endif // _REQUEST_COALESCER_H_
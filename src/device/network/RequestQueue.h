@@ -0,0 +1,61 @@
+#ifndef _REQUEST_QUEUE_H_
+#define _REQUEST_QUEUE_H_
+
+#include <Arduino.h>
+
+#include <deque>
+
+#include "device/INetwork.h"
+
+// A request waiting for a network worker
+struct PendingRequest {
+  HttpRequest req;
+  HttpCallback onDone;
+  unsigned long deadline = 0; // millis(); only meaningful if req.timeoutMs
+
+  bool expired(unsigned long now) const {
+    return req.timeoutMs > 0 && (long)(now - deadline) >= 0;
+  }
+  // ms left before the deadline, or fallback when there is none
+  uint32_t remaining(unsigned long now, uint32_t fallback) const {
+    if (req.timeoutMs == 0) return fallback;
+    long left = (long)(deadline - now);
+    return left > 0 ? (uint32_t)left : 0;
+  }
+};
+
+// Pending requests by priority, FIFO within a level. Not synchronised:
+// the owning network driver guards it.
+class RequestQueue {
+public:
+  void push(HttpRequest req, HttpCallback onDone) {
+    PendingRequest p;
+    p.deadline = millis() + req.timeoutMs;
+    RequestPriority priority = req.priority;
+    p.req = std::move(req);
+    p.onDone = std::move(onDone);
+    levels[(int)priority].push_back(std::move(p));
+  }
+
+  bool pop(PendingRequest &out) {
+    for (int i = (int)RequestPriority::Count - 1; i >= 0; i--) {
+      if (levels[i].empty()) continue;
+      out = std::move(levels[i].front());
+      levels[i].pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  bool empty() const {
+    for (const auto &level : levels) {
+      if (!level.empty()) return false;
+    }
+    return true;
+  }
+
+private:
+  std::deque<PendingRequest> levels[(int)RequestPriority::Count];
+};
+
+#endif // _REQUEST_QUEUE_H_
@@ -0,0 +1,137 @@
+#include "device/network/ResponseBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+#include <vector>
+
+#include "util/AllocTracker.h"
+
+#if defined(BOARD_HAS_PSRAM) && !defined(BOARD_SIMULATOR)
+#include <esp_heap_caps.h>
+#endif
+
+// 1K, 4K, 16K, 64K with the defaults
+#define RESPONSE_BUFFER_CLASSES 8
+
+static size_t classSize(int c) {
+  size_t size = (size_t)RESPONSE_BUFFER_MIN << (2 * c);
+  return size < RESPONSE_BUFFER_MAX ? size : RESPONSE_BUFFER_MAX;
+}
+
+// Smallest class holding len bytes; len must be <= RESPONSE_BUFFER_MAX
+static int classFor(size_t len) {
+  int c = 0;
+  while (c < RESPONSE_BUFFER_CLASSES - 1 && classSize(c) < len) c++;
+  return c;
+}
+
+static struct {
+  std::mutex mutex;
+  std::vector<char *> free[RESPONSE_BUFFER_CLASSES];
+  size_t pooledBytes = 0;
+} pool;
+
+// Blocks carry one byte past their class size for the terminating NUL
+static char *acquire(int c) {
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.free[c].empty()) {
+      char *block = pool.free[c].back();
+      pool.free[c].pop_back();
+      pool.pooledBytes -= classSize(c);
+      return block;
+    }
+  }
+  size_t bytes = classSize(c) + 1;
+#ifdef ALLOC_TRACKER
+  // counted in the phase that first needed the block, pooled or not
+  return (char *)AllocTracker::allocate(bytes);
+#else
+#if defined(BOARD_HAS_PSRAM) && !defined(BOARD_SIMULATOR)
+  // bodies are parsed once and dropped: keep them out of internal RAM
+  char *block = (char *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+  if (block) return block;
+#endif
+  return (char *)malloc(bytes);
+#endif
+}
+
+static void release(char *block, int c) {
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.pooledBytes + classSize(c) <= RESPONSE_BUFFER_POOL_BYTES) {
+      pool.free[c].push_back(block);
+      pool.pooledBytes += classSize(c);
+      return;
+    }
+  }
+#ifdef ALLOC_TRACKER
+  AllocTracker::deallocate(block);
+#else
+  free(block); // heap_caps_malloc blocks are free()d too
+#endif
+}
+
+ResponseBuffer &ResponseBuffer::operator=(ResponseBuffer &&other) noexcept {
+  if (this != &other) {
+    reset();
+    _data = other._data;
+    _size = other._size;
+    _class = other._class;
+    other._data = nullptr;
+    other._size = 0;
+    other._class = -1;
+  }
+  return *this;
+}
+
+size_t ResponseBuffer::capacity() const {
+  return _data ? classSize(_class) : 0;
+}
+
+bool ResponseBuffer::reserve(size_t len) {
+  if (len <= capacity()) return true;
+  if (len > RESPONSE_BUFFER_MAX) return false;
+  int c = classFor(len);
+  char *block = acquire(c);
+  if (!block) {
+    Serial.printf("[ResponseBuffer] out of memory for %u bytes\n",
+                  (unsigned)classSize(c));
+    return false;
+  }
+  if (_data) {
+    memcpy(block, _data, _size);
+    release(_data, _class);
+  }
+  block[_size] = '\0';
+  _data = block;
+  _class = c;
+  return true;
+}
+
+bool ResponseBuffer::append(const char *data, size_t len) {
+  if (!reserve(_size + len)) return false;
+  memcpy(_data + _size, data, len);
+  commit(len);
+  return true;
+}
+
+void ResponseBuffer::commit(size_t len) {
+  if (!_data) return;
+  _size += len;
+  _data[_size] = '\0';
+}
+
+void ResponseBuffer::clear() {
+  _size = 0;
+  if (_data) _data[0] = '\0';
+}
+
+void ResponseBuffer::reset() {
+  if (_data) release(_data, _class);
+  _data = nullptr;
+  _size = 0;
+  _class = -1;
+}
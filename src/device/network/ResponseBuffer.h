@@ -0,0 +1,75 @@
+#ifndef _RESPONSE_BUFFER_H_
+#define _RESPONSE_BUFFER_H_
+
+#include <Arduino.h>
+
+#include <stddef.h>
+
+#include <utility>
+
+// Smallest block; each size class is 4x the one before, up to the max
+#ifndef RESPONSE_BUFFER_MIN
+#define RESPONSE_BUFFER_MIN 1024
+#endif
+// Largest body accepted; a longer one fails with HTTP_ERROR_TOO_LARGE.
+// Streamed bodies (HttpRequest::onBody) are never buffered, so no limit.
+#ifndef RESPONSE_BUFFER_MAX
+#define RESPONSE_BUFFER_MAX (64 * 1024)
+#endif
+// Free blocks kept for reuse, in bytes across all classes. Internal RAM is
+// scarce; with PSRAM a few large blocks can stay around.
+#ifndef RESPONSE_BUFFER_POOL_BYTES
+#ifdef BOARD_HAS_PSRAM
+#define RESPONSE_BUFFER_POOL_BYTES (256 * 1024)
+#else
+#define RESPONSE_BUFFER_POOL_BYTES (24 * 1024)
+#endif
+#endif
+
+// A response body in a pooled, size-classed block (in PSRAM on boards that
+// have it). The network drivers write into it once and hand it over by
+// move; the block goes back to the pool when the consumer drops the
+// response, so steady polling reuses a few blocks instead of growing
+// Strings on the heap. Always NUL-terminated, so c_str() can go straight
+// to a parser.
+//
+// Move-only. The pool is thread-safe; a single buffer is not.
+class ResponseBuffer {
+  char *_data = nullptr;
+  size_t _size = 0;
+  int8_t _class = -1; // size class of _data; -1: none
+
+public:
+  ResponseBuffer() = default;
+  ResponseBuffer(ResponseBuffer &&other) noexcept { *this = std::move(other); }
+  ResponseBuffer &operator=(ResponseBuffer &&other) noexcept;
+  ResponseBuffer(const ResponseBuffer &) = delete;
+  ResponseBuffer &operator=(const ResponseBuffer &) = delete;
+  ~ResponseBuffer() { reset(); }
+
+  // Room for len bytes in all; false past RESPONSE_BUFFER_MAX or when out
+  // of memory (the contents are kept either way)
+  bool reserve(size_t len);
+  bool append(const char *data, size_t len);
+  bool assign(const char *data, size_t len) {
+    clear();
+    return append(data, len);
+  }
+  // After reserve(): fill from tail(), then commit() what was written
+  char *tail() { return _data + _size; }
+  void commit(size_t len);
+
+  const char *c_str() const { return _data ? _data : ""; }
+  const char *data() const { return c_str(); }
+  size_t size() const { return _size; }
+  size_t length() const { return _size; }
+  bool empty() const { return _size == 0; }
+  size_t capacity() const;
+
+  // Empty, keeping the block
+  void clear();
+  // Empty, returning the block to the pool
+  void reset();
+};
+
+#endif // _RESPONSE_BUFFER_H_
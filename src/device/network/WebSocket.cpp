@@ -0,0 +1,241 @@
+#include "device/network/WebSocket.h"
+#include "device/network/WebSocketKey.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#ifdef BOARD_SIMULATOR
+#include <random>
+#else
+#include <esp_random.h>
+#endif
+
+enum : uint8_t {
+  OP_CONTINUATION = 0x0,
+  OP_TEXT = 0x1,
+  OP_BINARY = 0x2,
+  OP_CLOSE = 0x8,
+  OP_PING = 0x9,
+  OP_PONG = 0xA,
+};
+
+static uint32_t randomWord() {
+#ifdef BOARD_SIMULATOR
+  static std::random_device rd;
+  return rd();
+#else
+  return esp_random();
+#endif
+}
+
+// Value of a response header, case-insensitively; "" if absent
+static std::string headerValue(const std::string &head, const char *name) {
+  size_t nameLen = strlen(name);
+  size_t pos = head.find("\r\n");
+  while (pos != std::string::npos) {
+    size_t start = pos + 2;
+    size_t end = head.find("\r\n", start);
+    if (end == std::string::npos) end = head.size();
+    if (end - start > nameLen && head[start + nameLen] == ':' &&
+        strncasecmp(head.c_str() + start, name, nameLen) == 0) {
+      size_t v = start + nameLen + 1;
+      while (v < end && head[v] == ' ') v++;
+      return head.substr(v, end - v);
+    }
+    pos = end < head.size() ? end : std::string::npos;
+  }
+  return "";
+}
+
+bool WebSocket::connect(const char *url, uint32_t timeoutMs) {
+  close();
+  const char *p = strstr(url, "://");
+  p = p ? p + 3 : url;
+  const char *slash = strchr(p, '/');
+  std::string authority = slash ? std::string(p, slash - p) : std::string(p);
+  const char *path = slash ? slash : "/";
+  uint16_t port = 80;
+  size_t colon = authority.find(':');
+  if (colon != std::string::npos) {
+    port = (uint16_t)atoi(authority.c_str() + colon + 1);
+    authority.resize(colon);
+  }
+
+  if (!_socket->connect(authority.c_str(), port, timeoutMs)) return false;
+  if (!handshake(authority.c_str(), port, path, timeoutMs)) {
+    _socket->close();
+    return false;
+  }
+  _open = true;
+  return true;
+}
+
+bool WebSocket::handshake(const char *host, uint16_t port, const char *path,
+                          uint32_t timeoutMs) {
+  uint8_t nonce[16];
+  for (int i = 0; i < 16; i += 4) {
+    uint32_t r = randomWord();
+    memcpy(nonce + i, &r, 4);
+  }
+  std::string key = base64Encode(nonce, sizeof(nonce));
+
+  char request[384];
+  int n = snprintf(request, sizeof(request),
+                   "GET %s HTTP/1.1\r\nHost: %s:%u\r\nUpgrade: websocket\r\n"
+                   "Connection: Upgrade\r\nSec-WebSocket-Key: %s\r\n"
+                   "Sec-WebSocket-Version: 13\r\n\r\n",
+                   path, host, (unsigned)port, key.c_str());
+  if (n <= 0 || n >= (int)sizeof(request)) return false;
+  if (!_socket->write((const uint8_t *)request, n)) return false;
+
+  // read the response head; anything after it is already frame data
+  std::string head;
+  unsigned long start = millis();
+  size_t end;
+  while ((end = head.find("\r\n\r\n")) == std::string::npos) {
+    uint32_t elapsed = millis() - start;
+    if (elapsed >= timeoutMs || head.size() > 4096) return false;
+    uint8_t buf[256];
+    int got = _socket->read(buf, sizeof(buf), timeoutMs - elapsed);
+    if (got < 0) return false;
+    head.append((const char *)buf, got);
+  }
+  _rx.assign(head.begin() + end + 4, head.end());
+  head.resize(end);
+
+  if (head.compare(0, 12, "HTTP/1.1 101") != 0) {
+    Serial.printf("[WebSocket] upgrade refused: %s\n",
+                  head.substr(0, head.find("\r\n")).c_str());
+    return false;
+  }
+  if (headerValue(head, "Sec-WebSocket-Accept") != webSocketAcceptKey(key.c_str())) {
+    Serial.println("[WebSocket] bad Sec-WebSocket-Accept");
+    return false;
+  }
+  return true;
+}
+
+void WebSocket::close() {
+  if (_open) {
+    // 1000: normal closure
+    const uint8_t code[2] = {0x03, 0xE8};
+    sendFrame(OP_CLOSE, code, sizeof(code));
+  }
+  _open = false;
+  _socket->close();
+  _rx.clear();
+  _message.clear();
+}
+
+// Client frames are always masked (RFC 6455 5.3)
+bool WebSocket::sendFrame(uint8_t opcode, const uint8_t *data, size_t len) {
+  std::vector<uint8_t> frame;
+  frame.reserve(len + 14);
+  frame.push_back(0x80 | opcode); // FIN: we never fragment
+  if (len < 126) {
+    frame.push_back(0x80 | (uint8_t)len);
+  } else if (len <= 0xFFFF) {
+    frame.push_back(0x80 | 126);
+    frame.push_back((uint8_t)(len >> 8));
+    frame.push_back((uint8_t)len);
+  } else {
+    frame.push_back(0x80 | 127);
+    for (int i = 7; i >= 0; i--) frame.push_back((uint8_t)((uint64_t)len >> (i * 8)));
+  }
+  uint32_t maskWord = randomWord();
+  uint8_t mask[4];
+  memcpy(mask, &maskWord, 4);
+  frame.insert(frame.end(), mask, mask + 4);
+  for (size_t i = 0; i < len; i++) frame.push_back(data[i] ^ mask[i % 4]);
+  return _socket->write(frame.data(), frame.size());
+}
+
+bool WebSocket::sendText(const char *data, size_t len) {
+  if (!_open) return false;
+  if (!sendFrame(OP_TEXT, (const uint8_t *)data, len)) {
+    _open = false;
+    return false;
+  }
+  return true;
+}
+
+WebSocket::Result WebSocket::receive(std::string &message, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (_open) {
+    // parse one frame if it is all here
+    size_t have = _rx.size();
+    size_t headerLen = 2;
+    uint64_t payloadLen = 0;
+    bool complete = false;
+    if (have >= 2) {
+      payloadLen = _rx[1] & 0x7F;
+      if (payloadLen == 126) headerLen += 2;
+      else if (payloadLen == 127) headerLen += 8;
+      bool masked = _rx[1] & 0x80; // servers shouldn't, but may
+      if (masked) headerLen += 4;
+      if (have >= headerLen) {
+        if ((_rx[1] & 0x7F) == 126) {
+          payloadLen = ((uint64_t)_rx[2] << 8) | _rx[3];
+        } else if ((_rx[1] & 0x7F) == 127) {
+          payloadLen = 0;
+          for (int i = 0; i < 8; i++) payloadLen = (payloadLen << 8) | _rx[2 + i];
+        }
+        if (payloadLen + _message.size() > WEBSOCKET_MAX_MESSAGE) {
+          Serial.printf("[WebSocket] message over %d bytes, closing\n",
+                        WEBSOCKET_MAX_MESSAGE);
+          close();
+          return Result::Closed;
+        }
+        complete = have >= headerLen + payloadLen;
+        if (complete && masked) {
+          const uint8_t *mask = &_rx[headerLen - 4];
+          for (size_t i = 0; i < payloadLen; i++) _rx[headerLen + i] ^= mask[i % 4];
+        }
+      }
+    }
+
+    if (!complete) {
+      uint32_t elapsed = millis() - start;
+      if (elapsed >= timeoutMs) return Result::Timeout;
+      uint8_t buf[1024];
+      int got = _socket->read(buf, sizeof(buf), timeoutMs - elapsed);
+      if (got < 0) {
+        _open = false;
+        return Result::Closed;
+      }
+      _rx.insert(_rx.end(), buf, buf + got);
+      continue;
+    }
+
+    bool fin = _rx[0] & 0x80;
+    uint8_t opcode = _rx[0] & 0x0F;
+    const uint8_t *payload = _rx.data() + headerLen;
+    bool delivered = false;
+    switch (opcode) {
+    case OP_TEXT:
+    case OP_CONTINUATION:
+      _message.append((const char *)payload, (size_t)payloadLen);
+      if (fin) {
+        message.swap(_message);
+        _message.clear();
+        delivered = true;
+      }
+      break;
+    case OP_PING:
+      sendFrame(OP_PONG, payload, (size_t)payloadLen);
+      break;
+    case OP_CLOSE:
+      // echo the status code back, then drop the connection
+      sendFrame(OP_CLOSE, payload, payloadLen >= 2 ? 2 : 0);
+      _open = false;
+      _socket->close();
+      return Result::Closed;
+    default: // binary and pong: not used
+      break;
+    }
+    _rx.erase(_rx.begin(), _rx.begin() + headerLen + (size_t)payloadLen);
+    if (delivered) return Result::Message;
+  }
+  return Result::Closed;
+}
@@ -0,0 +1,49 @@
+#ifndef _WEBSOCKET_H_
+#define _WEBSOCKET_H_
+
+#include <Arduino.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "device/ISocket.h"
+
+// Largest message accepted; HA's first subscribe_entities event carries
+// every subscribed entity's full state
+#ifndef WEBSOCKET_MAX_MESSAGE
+#define WEBSOCKET_MAX_MESSAGE (64 * 1024)
+#endif
+
+// Minimal RFC 6455 client over an ISocket: ws:// only, text messages, no
+// extensions. Pings are answered and close frames handled inside
+// receive(). Blocking, for one thread at a time.
+class WebSocket {
+public:
+  enum class Result { Message, Timeout, Closed };
+
+  explicit WebSocket(std::unique_ptr<ISocket> socket)
+      : _socket(std::move(socket)) {}
+
+  // "ws://host[:port]/path" (http:// is taken to mean the same)
+  bool connect(const char *url, uint32_t timeoutMs);
+  bool connected() const { return _open; }
+  void close();
+
+  bool sendText(const char *data, size_t len);
+  bool sendText(const String &text) { return sendText(text.c_str(), text.length()); }
+  // Wait up to timeoutMs for the next complete text message
+  Result receive(std::string &message, uint32_t timeoutMs);
+
+private:
+  std::unique_ptr<ISocket> _socket;
+  bool _open = false;
+  std::vector<uint8_t> _rx; // read but not yet parsed
+  std::string _message;     // fragments so far
+
+  bool sendFrame(uint8_t opcode, const uint8_t *data, size_t len);
+  bool handshake(const char *host, uint16_t port, const char *path,
+                 uint32_t timeoutMs);
+};
+
+#endif // _WEBSOCKET_H_
@@ -0,0 +1,61 @@
+#include "device/network/WebSocketKey.h"
+
+// SHA-1, only for the handshake's Sec-WebSocket-Accept
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  auto rol = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+  uint64_t bits = (uint64_t)len * 8;
+  size_t total = ((len + 8) / 64 + 1) * 64;
+  for (size_t block = 0; block < total; block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      uint32_t word = 0;
+      for (int b = 0; b < 4; b++) {
+        size_t pos = block + i * 4 + b;
+        uint8_t byte;
+        if (pos < len) byte = data[pos];
+        else if (pos == len) byte = 0x80;
+        else if (pos >= total - 8) byte = (uint8_t)(bits >> ((total - 1 - pos) * 8));
+        else byte = 0;
+        word = (word << 8) | byte;
+      }
+      w[i] = word;
+    }
+    for (int i = 16; i < 80; i++) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) f = (b & c) | (~b & d), k = 0x5A827999;
+      else if (i < 40) f = b ^ c ^ d, k = 0x6ED9EBA1;
+      else if (i < 60) f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+      else f = b ^ c ^ d, k = 0xCA62C1D6;
+      uint32_t t = rol(a, 5) + f + e + k + w[i];
+      e = d, d = c, c = rol(b, 30), b = a, a = t;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e;
+  }
+  for (int i = 0; i < 20; i++) out[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+}
+
+std::string base64Encode(const uint8_t *data, size_t len) {
+  static const char *alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t n = (uint32_t)data[i] << 16;
+    if (i + 1 < len) n |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < len) n |= data[i + 2];
+    out += alphabet[(n >> 18) & 63];
+    out += alphabet[(n >> 12) & 63];
+    out += i + 1 < len ? alphabet[(n >> 6) & 63] : '=';
+    out += i + 2 < len ? alphabet[n & 63] : '=';
+  }
+  return out;
+}
+
+std::string webSocketAcceptKey(const char *key) {
+  std::string input = std::string(key) + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  uint8_t digest[20];
+  sha1((const uint8_t *)input.data(), input.size(), digest);
+  return base64Encode(digest, sizeof(digest));
+}
@@ -0,0 +1,16 @@
+#ifndef _WEBSOCKET_KEY_H_
+#define _WEBSOCKET_KEY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+// Handshake helpers with no Arduino dependencies, shared by WebSocket and
+// the simulator's mock server
+
+std::string base64Encode(const uint8_t *data, size_t len);
+// Sec-WebSocket-Accept for a Sec-WebSocket-Key (RFC 6455 4.2.2)
+std::string webSocketAcceptKey(const char *key);
+
+#endif // _WEBSOCKET_KEY_H_
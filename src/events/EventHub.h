@@ -4,12 +4,17 @@
 #include "events/types/TouchEvent.h"
 #include "events/types/WorkflowEvent.h"
 
+// Workflow changes are posted from anywhere and delivered by
+// Application::loop; only the latest target of a burst matters.
+using WorkflowEventQueue =
+    EventQueue<WorkflowEvent, 8, OverflowPolicy::Coalesce>;
+
 class EventHub : public EventHandler<WorkflowEvent> {
 private:
-  EventQueue<WorkflowEvent> _workflowEventQueue;
+  WorkflowEventQueue _workflowEventQueue;
 
 public:
   void handleEvent(WorkflowEvent &event) { _workflowEventQueue.post(event); }
 
-  EventQueue<WorkflowEvent> &workflowEvents() { return _workflowEventQueue; }
+  WorkflowEventQueue &workflowEvents() { return _workflowEventQueue; }
 };
\ No newline at end of file
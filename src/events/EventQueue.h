@@ -1,37 +1,114 @@
 #ifndef _EVENT_QUEUE_H_
 #define _EVENT_QUEUE_H_
 
-#include <list>
+#include <atomic>
+
+#ifdef BOARD_SIMULATOR
+#include <thread>
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
 
 #include "events/EventHandler.h"
+#include "events/RingBuffer.h"
+
+#define EVENT_QUEUE_MAX_SUBSCRIBERS 4
+
+// What post() does when the queue is full
+enum class OverflowPolicy {
+  DropOldest, // discard the oldest pending event to make room
+  Coalesce,   // merge adjacent events at drain (coalesceEvent), else drop oldest
+  Block,      // wait for the consumer; never use from an ISR or the UI loop
+};
 
-// basic generic message queue
-template <typename T> class EventQueue : public EventHandler<T> {
+// Merge `next` into `pending` if the pair can be delivered as one event.
+// Overload for an event type to opt in to OverflowPolicy::Coalesce.
+template <typename T> inline bool coalesceEvent(T &pending, const T &next) {
+  return false;
+}
+
+// Bounded message queue. post() copies the event into a lock-free ring
+// buffer and returns — safe from other tasks, cores and ISRs, and never
+// allocates. The owner calls drain() from the UI loop, which delivers
+// pending events to subscribers in FIFO order.
+template <typename T, size_t N = 16,
+          OverflowPolicy Policy = OverflowPolicy::DropOldest>
+class EventQueue : public EventHandler<T> {
 private:
-  std::list<T> queue;
-  std::list<EventHandler<T> *> eventHandlerQueue;
+  RingBuffer<T, N> queue;
+  EventHandler<T> *subscribers[EVENT_QUEUE_MAX_SUBSCRIBERS] = {};
+  std::atomic<uint32_t> dropCount{0};
 
   void notify(T &event) {
-    for (EventHandler<T> *eventHandler : eventHandlerQueue) {
-      eventHandler->handleEvent(event);
+    for (EventHandler<T> *eventHandler : subscribers) {
+      if (eventHandler != nullptr) eventHandler->handleEvent(event);
     }
   }
 
+  static void waitForSpace() {
+#ifdef BOARD_SIMULATOR
+    std::this_thread::yield();
+#else
+    vTaskDelay(1);
+#endif
+  }
+
 public:
-  void post(T event) {
-    queue.push_back(event);
-    notify(event);
+  // Returns false if an event had to be dropped
+  bool post(const T &event) {
+    if (queue.tryPush(event)) return true;
+    if (Policy == OverflowPolicy::Block) {
+      while (!queue.tryPush(event)) waitForSpace();
+      return true;
+    }
+    // DropOldest / Coalesce: make room by discarding the head
+    T discarded;
+    do {
+      if (queue.tryPop(discarded)) dropCount.fetch_add(1, std::memory_order_relaxed);
+    } while (!queue.tryPush(event));
+    return false;
+  }
+
+  // Deliver up to maxBatch pending events; returns how many were delivered
+  size_t drain(size_t maxBatch = N) {
+    size_t delivered = 0;
+    T event;
+    if (!queue.tryPop(event)) return 0;
+    for (size_t taken = 1;; taken++) {
+      T next;
+      bool more = taken < maxBatch && queue.tryPop(next);
+      if (more && Policy == OverflowPolicy::Coalesce && coalesceEvent(event, next)) {
+        continue;
+      }
+      notify(event);
+      delivered++;
+      if (!more) break;
+      event = next;
+    }
+    return delivered;
   }
 
   void subscribe(EventHandler<T> *eventHandler) {
-    eventHandlerQueue.push_back(eventHandler);
+    for (EventHandler<T> *&slot : subscribers) {
+      if (slot == nullptr) {
+        slot = eventHandler;
+        return;
+      }
+    }
   }
 
   void unsubscribe(EventHandler<T> *eventHandler) {
-    eventHandlerQueue.remove(eventHandler);
+    for (EventHandler<T> *&slot : subscribers) {
+      if (slot == eventHandler) slot = nullptr;
+    }
   }
 
   void handleEvent(T &event) { post(event); }
+
+  // Pending (not yet drained) events
+  size_t size() const { return queue.size(); }
+  uint32_t dropped() const { return dropCount.load(std::memory_order_relaxed); }
 };
 
-#endif // _EVENT_QUEUE_H_
\ No newline at end of file
+#endif // _EVENT_QUEUE_H_
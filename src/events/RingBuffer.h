@@ -0,0 +1,90 @@
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-capacity lock-free queue (Vyukov's bounded queue). Each cell
+// carries a sequence number that tells producers and consumers whether it
+// is free or full for the current lap, so pushes from several tasks, cores
+// or ISRs never allocate and never take a lock. Safe with multiple
+// consumers too, which lets a producer discard the oldest entry itself.
+//
+// N must be a power of two. T must be trivially copyable in practice
+// (it is copied in and out of the cell).
+template <typename T, size_t N> class RingBuffer {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    T data;
+  };
+
+  Cell cells[N];
+  std::atomic<uint32_t> head{0}; // next slot to push
+  std::atomic<uint32_t> tail{0}; // next slot to pop
+
+public:
+  RingBuffer() {
+    for (size_t i = 0; i < N; i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns false if the buffer is full
+  bool tryPush(const T &value) {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells[pos & (N - 1)];
+      uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+      int32_t diff = (int32_t)(seq - pos);
+      if (diff == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.data = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the buffer is empty
+  bool tryPop(T &out) {
+    uint32_t pos = tail.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells[pos & (N - 1)];
+      uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+      int32_t diff = (int32_t)(seq - (pos + 1));
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          out = cell.data;
+          cell.sequence.store(pos + N, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Approximate while producers are running
+  size_t size() const {
+    uint32_t h = head.load(std::memory_order_acquire);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    int32_t n = (int32_t)(h - t);
+    if (n < 0) return 0;
+    return n > (int32_t)N ? N : (size_t)n;
+  }
+
+  static constexpr size_t capacity() { return N; }
+};
+
+#endif // _RING_BUFFER_H_
@@ -4,7 +4,14 @@
 #include "device/types/TouchLocation.h"
 #include "events/types/InputEvent.h"
 
-enum class TouchType { UnknownType, SwipeType, TapType };
+enum class TouchType {
+  UnknownType,
+  SwipeType,
+  TapType,
+  DoubleTapType,
+  LongPressType,
+  DragType
+};
 enum class SwipeDirection {
   UnknownDirection,
   SwipeUp,
@@ -16,6 +23,8 @@ enum class SwipeDirection {
 class TouchEvent : public InputEvent {
 public:
   unsigned long timestamp = 0;
+  // LatencyTracer id set by the driver that produced the event (0 = untraced)
+  uint16_t traceId = 0;
   TouchType type;
   TouchLocation location = {};
 
@@ -58,6 +67,8 @@ class SwipeTouchEvent : public TouchEvent {
 public:
   SwipeDirection direction;
   TouchLocation startLocation = {};
+  // release velocity in px/s (0 if the source doesn't measure it)
+  int velocityX = 0, velocityY = 0;
 
   SwipeTouchEvent(SwipeDirection direction)
       : TouchEvent(TouchType::SwipeType), direction(direction) {};
@@ -84,4 +95,35 @@ public:
   }
 };
 
+// Two taps within the board's double-tap window (disabled by default)
+class DoubleTapTouchEvent : public TouchEvent {
+public:
+  DoubleTapTouchEvent(TouchLocation location) : TouchEvent(TouchType::DoubleTapType) {
+    this->location = location;
+  };
+};
+
+class LongPressTouchEvent : public TouchEvent {
+public:
+  LongPressTouchEvent(TouchLocation location) : TouchEvent(TouchType::LongPressType) {
+    this->location = location;
+  };
+};
+
+enum class DragPhase { DragStart, DragMove, DragEnd };
+
+// Contact moving beyond the tap slop. A drag that ends fast and far enough
+// is reported as a SwipeTouchEvent instead of DragEnd.
+class DragTouchEvent : public TouchEvent {
+public:
+  DragPhase phase;
+  TouchLocation startLocation = {};
+  int velocityX = 0, velocityY = 0; // px/s, DragEnd only
+
+  DragTouchEvent(DragPhase phase, TouchLocation startLocation, TouchLocation location)
+      : TouchEvent(TouchType::DragType), phase(phase), startLocation(startLocation) {
+    this->location = location;
+  };
+};
+
 #endif // _TOUCH_EVENT_T_
\ No newline at end of file
@@ -9,4 +9,11 @@ struct WorkflowEvent {
   unsigned long timestamp = 0;
 };
 
+// Back-to-back navigations collapse into a single rebuild of the final state
+inline bool coalesceEvent(WorkflowEvent &pending, const WorkflowEvent &next) {
+  pending.to = next.to;
+  pending.timestamp = next.timestamp;
+  return true;
+}
+
 #endif // _WORKFLOW_EVENT_T_
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "device/Device.h"
 #include "application/Application.h"
+#include "util/LatencyTracer.h"
+#include "util/RenderProfiler.h"
 
 Device device;
 Application app(&device);
@@ -10,9 +12,16 @@ void setup(void) {
   Serial.begin(115200);
   device.init();
   app.init();
+#ifdef RENDER_PROFILER_LOG
+  // per-second FPS / frame-time / flush stats on serial
+  RenderProfiler::setLogging(true);
+#endif
+#ifdef LATENCY_TRACE_LOG
+  // one line per touch: gesture/dispatch/navigate/rebuild/photon times
+  LatencyTracer::setLogging(true);
+#endif
 }
 
 void loop() {
-  // TODO render metrics
   app.loop();
 }
@@ -1,6 +1,7 @@
 #ifndef _JSON_TREE_PARSER_H_
 #define _JSON_TREE_PARSER_H_
 
+#include <algorithm>
 #include <vector>
 
 #include <ArduinoJson.h>
@@ -10,23 +11,33 @@
 // Recursive JSON → Component* builder.
 // Walks {"type", "props", "children"} nodes, looks up types in
 // the ComponentRegistry, recurses on children, and returns a tree.
+// Optionally collects the "entity" of every node on the way, so the
+// screen's HA states can be fetched in one request.
 
 class JsonTreeParser {
 public:
   static Component *build(const JsonObject &node,
-                          const ComponentRegistry &registry) {
+                          const ComponentRegistry &registry,
+                          std::vector<String> *entityIds = nullptr) {
     const char *type = node["type"] | (const char *)nullptr;
     if (type == nullptr) {
       Serial.println("[JsonTreeParser] Node missing \"type\" key");
       return new Component();
     }
 
+    const char *entity = node["entity"] | "";
+    if (entityIds != nullptr && entity[0] != '\0' &&
+        std::find(entityIds->begin(), entityIds->end(), entity) ==
+            entityIds->end()) {
+      entityIds->push_back(entity);
+    }
+
     // Recurse on children first (depth-first)
     std::vector<Component *> kids;
     JsonArray childArr = node["children"];
     if (childArr) {
       for (JsonObject child : childArr) {
-        Component *c = build(child, registry);
+        Component *c = build(child, registry, entityIds);
         if (c != nullptr) kids.push_back(c);
       }
     }
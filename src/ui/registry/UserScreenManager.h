@@ -1,6 +1,7 @@
 #ifndef _USER_SCREEN_MANAGER_H_
 #define _USER_SCREEN_MANAGER_H_
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
@@ -9,6 +10,8 @@
 #include "application/workflow/Workflow.h"
 #include "ui/registry/ComponentRegistry.h"
 #include "ui/registry/JsonTreeParser.h"
+#include "util/AllocTracker.h"
+#include "util/JsonAllocator.h"
 
 class UserScreenManager {
 public:
@@ -25,12 +28,27 @@ private:
   State _defaultScreen = USER_STATE_BASE;
   // Keeps parsed JSON alive so const char* pointers remain valid
   // until the next screen build or manifest reload.
-  JsonDocument _activeDoc;
+  JsonDocument _activeDoc{jsonAllocator()};
   bool _loaded = false;
+  // every "entity" referenced by any screen, without duplicates
+  std::vector<String> _entityIds;
+
+  void collectEntities(JsonVariantConst node) {
+    const char *entity = node["entity"] | "";
+    if (entity[0] != '\0' &&
+        std::find(_entityIds.begin(), _entityIds.end(), entity) ==
+            _entityIds.end()) {
+      _entityIds.push_back(entity);
+    }
+    for (JsonVariantConst child : node["children"].as<JsonArrayConst>()) {
+      collectEntities(child);
+    }
+  }
 
 public:
   bool loadManifest(const char *json) {
-    JsonDocument doc;
+    AllocScope scope(AllocPhase::Manifest);
+    JsonDocument doc(jsonAllocator());
     DeserializationError err = deserializeJson(doc, json);
     if (err) {
       Serial.printf("[UserScreenManager] JSON parse error: %s\n",
@@ -40,6 +58,7 @@ public:
 
     _screenJsons.clear();
     _tabs.clear();
+    _entityIds.clear();
 
     _defaultScreen = doc["default_screen"] | (int)USER_STATE_BASE;
 
@@ -63,6 +82,7 @@ public:
         String serialized;
         serializeJson(kv.value(), serialized);
         _screenJsons[stateId] = std::move(serialized);
+        collectEntities(kv.value());
       }
     }
 
@@ -78,7 +98,9 @@ public:
     return _screenJsons.count(state) > 0;
   }
 
-  Component *buildScreen(State state, const ComponentRegistry &registry) {
+  // entityIds, if given, receives every entity the screen references
+  Component *buildScreen(State state, const ComponentRegistry &registry,
+                         std::vector<String> *entityIds = nullptr) {
     auto it = _screenJsons.find(state);
     if (it == _screenJsons.end()) return nullptr;
 
@@ -95,11 +117,13 @@ public:
     }
 
     JsonObject root = _activeDoc.as<JsonObject>();
-    return JsonTreeParser::build(root, registry);
+    return JsonTreeParser::build(root, registry, entityIds);
   }
 
   const std::vector<TabDef> &tabs() const { return _tabs; }
   State defaultScreen() const { return _defaultScreen; }
+  // for HomeAssistant::watchEntities
+  const std::vector<String> &entityIds() const { return _entityIds; }
   bool isLoaded() const { return _loaded; }
 };
 
@@ -0,0 +1,376 @@
+#include "util/AllocTracker.h"
+
+#ifdef ALLOC_TRACKER
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "lvgl.h"
+
+#ifdef BOARD_SIMULATOR
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#else
+#include <esp_heap_caps.h>
+#endif
+
+// With -Wl,--wrap=malloc,... (ALLOC_TRACKER_WRAP_MALLOC, see
+// platformio.ini) plain malloc lands in __wrap_malloc below, so the
+// tracker's own blocks must come from the real one
+#ifdef ALLOC_TRACKER_WRAP_MALLOC
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_realloc(void *p, size_t size);
+void __real_free(void *p);
+}
+#define rawMalloc __real_malloc
+#define rawRealloc __real_realloc
+#define rawFree __real_free
+#else
+#define rawMalloc malloc
+#define rawRealloc realloc
+#define rawFree free
+#endif
+
+// Screen states remembered for the navigate-away/back comparison
+#define ALLOC_TRACKER_MAX_SCREENS 32
+
+struct AllocHeader {
+  uint32_t magic; // ALLOC_MAGIC ^ header address while live
+  uint32_t size;
+  uint8_t phase;
+  uint8_t lvgl;
+};
+
+#define ALLOC_MAGIC 0xA110C8EDu
+
+// Keep the user pointer aligned like malloc's
+static constexpr size_t HEADER_SIZE =
+    (sizeof(AllocHeader) + alignof(std::max_align_t) - 1) /
+    alignof(std::max_align_t) * alignof(std::max_align_t);
+
+struct PhaseCounters {
+  std::atomic<uint32_t> allocs{0};
+  std::atomic<uint32_t> frees{0};
+  std::atomic<uint32_t> bytesAllocated{0};
+  std::atomic<int32_t> liveBytes{0};
+  std::atomic<int32_t> peakLiveBytes{0};
+};
+
+static const char *PHASE_NAMES[] = {"other",   "manifest", "build",
+                                    "widgets", "network",  "ha_string"};
+
+// per thread: a network worker's scope must not relabel the UI thread's
+// allocations, nor restore over its phase
+static thread_local uint8_t s_phase = 0;
+static PhaseCounters s_counters[(int)AllocPhase::Count];
+static std::atomic<int32_t> s_live{0};
+static std::atomic<int32_t> s_lvglLive{0};
+static std::atomic<int32_t> s_transitionPeak{0};
+
+// transition bookkeeping (UI thread only)
+struct TransitionMark {
+  uint32_t allocs;
+  uint32_t bytes;
+  int32_t live[(int)AllocPhase::Count];
+};
+static TransitionMark s_transitionStart;
+static int32_t s_teardownStart[(int)AllocPhase::Count];
+
+struct ScreenVisit {
+  int state;
+  int32_t live[(int)AllocPhase::Count];
+};
+static ScreenVisit s_visits[ALLOC_TRACKER_MAX_SCREENS];
+static int s_visitCount = 0;
+
+static uint32_t magicFor(const AllocHeader *hdr) {
+  return ALLOC_MAGIC ^ (uint32_t)(uintptr_t)hdr;
+}
+
+static void *trackedAlloc(size_t size, bool lvgl) {
+  auto *hdr = (AllocHeader *)rawMalloc(size + HEADER_SIZE);
+  if (hdr == nullptr) return nullptr;
+  uint8_t phase = s_phase;
+  hdr->magic = magicFor(hdr);
+  hdr->size = (uint32_t)size;
+  hdr->phase = phase;
+  hdr->lvgl = lvgl;
+
+  PhaseCounters &c = s_counters[phase];
+  c.allocs.fetch_add(1, std::memory_order_relaxed);
+  c.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+  int32_t phaseLive = c.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  if (phaseLive > c.peakLiveBytes.load(std::memory_order_relaxed)) {
+    c.peakLiveBytes.store(phaseLive, std::memory_order_relaxed);
+  }
+  int32_t live = s_live.fetch_add(size, std::memory_order_relaxed) + size;
+  if (live > s_transitionPeak.load(std::memory_order_relaxed)) {
+    s_transitionPeak.store(live, std::memory_order_relaxed);
+  }
+  if (lvgl) s_lvglLive.fetch_add(size, std::memory_order_relaxed);
+  return (uint8_t *)hdr + HEADER_SIZE;
+}
+
+static void trackedFree(void *p) {
+  if (p == nullptr) return;
+  auto *hdr = (AllocHeader *)((uint8_t *)p - HEADER_SIZE);
+  PhaseCounters &c = s_counters[hdr->phase];
+  c.frees.fetch_add(1, std::memory_order_relaxed);
+  c.liveBytes.fetch_sub(hdr->size, std::memory_order_relaxed);
+  s_live.fetch_sub(hdr->size, std::memory_order_relaxed);
+  if (hdr->lvgl) s_lvglLive.fetch_sub(hdr->size, std::memory_order_relaxed);
+  hdr->magic = 0;
+  rawFree(hdr);
+}
+
+static void *trackedRealloc(void *p, size_t size, bool lvgl) {
+  if (p == nullptr) return trackedAlloc(size, lvgl);
+  if (size == 0) {
+    trackedFree(p);
+    return nullptr;
+  }
+  auto *hdr = (AllocHeader *)((uint8_t *)p - HEADER_SIZE);
+  void *np = trackedAlloc(size, lvgl);
+  if (np == nullptr) return nullptr;
+  memcpy(np, p, hdr->size < size ? hdr->size : size);
+  trackedFree(p);
+  return np;
+}
+
+static void *trackedNew(size_t size) {
+  void *p = trackedAlloc(size, false);
+  if (p == nullptr) {
+#if __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    abort();
+#endif
+  }
+  return p;
+}
+
+// --- global operator new/delete replacements ---
+
+void *operator new(size_t size) { return trackedNew(size); }
+void *operator new[](size_t size) { return trackedNew(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return trackedAlloc(size, false);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return trackedAlloc(size, false);
+}
+void operator delete(void *p) noexcept { trackedFree(p); }
+void operator delete[](void *p) noexcept { trackedFree(p); }
+void operator delete(void *p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void *p, size_t) noexcept { trackedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+
+// --- LVGL custom allocator (LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM) ---
+
+void lv_mem_init(void) {}
+
+void lv_mem_deinit(void) {}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes) {
+  LV_UNUSED(mem);
+  LV_UNUSED(bytes);
+  return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool) { LV_UNUSED(pool); }
+
+void *lv_malloc_core(size_t size) { return trackedAlloc(size, true); }
+
+void *lv_realloc_core(void *p, size_t new_size) {
+  return trackedRealloc(p, new_size, true);
+}
+
+void lv_free_core(void *p) { trackedFree(p); }
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p) { memset(mon_p, 0, sizeof(*mon_p)); }
+
+lv_result_t lv_mem_test_core(void) { return LV_RESULT_OK; }
+
+// --- malloc/realloc/free (ESP32, linked with -Wl,--wrap=...) ---
+
+#ifdef ALLOC_TRACKER_WRAP_MALLOC
+
+// Blocks from heap_caps_malloc, newlib's internal allocator or before the
+// wrap took effect can still reach free()/realloc(); they carry no header
+// and go straight to the real allocator. For those the header slot
+// overlaps the heap's own bookkeeping, so reading it is safe.
+static bool isTracked(void *p) {
+  auto *hdr = (AllocHeader *)((uint8_t *)p - HEADER_SIZE);
+  return hdr->magic == magicFor(hdr);
+}
+
+extern "C" void *__wrap_malloc(size_t size) { return trackedAlloc(size, false); }
+
+extern "C" void *__wrap_realloc(void *p, size_t size) {
+  if (p != nullptr && !isTracked(p)) return __real_realloc(p, size);
+  return trackedRealloc(p, size, false);
+}
+
+extern "C" void __wrap_free(void *p) {
+  if (p != nullptr && !isTracked(p)) {
+    __real_free(p);
+    return;
+  }
+  trackedFree(p);
+}
+
+#endif // ALLOC_TRACKER_WRAP_MALLOC
+
+// --- AllocTracker ---
+
+void *AllocTracker::allocate(size_t size) { return trackedAlloc(size, false); }
+
+void *AllocTracker::reallocate(void *p, size_t size) {
+  return trackedRealloc(p, size, false);
+}
+
+void AllocTracker::deallocate(void *p) { trackedFree(p); }
+
+AllocPhase AllocTracker::phase() {
+  return (AllocPhase)s_phase;
+}
+
+void AllocTracker::setPhase(AllocPhase phase) {
+  s_phase = (uint8_t)phase;
+}
+
+AllocPhaseStats AllocTracker::stats(AllocPhase phase) {
+  PhaseCounters &c = s_counters[(int)phase];
+  AllocPhaseStats s;
+  s.allocs = c.allocs.load();
+  s.frees = c.frees.load();
+  s.bytesAllocated = c.bytesAllocated.load();
+  s.liveBytes = c.liveBytes.load();
+  s.peakLiveBytes = c.peakLiveBytes.load();
+  return s;
+}
+
+int32_t AllocTracker::liveBytes() { return s_live.load(); }
+
+int32_t AllocTracker::lvglLiveBytes() { return s_lvglLive.load(); }
+
+static uint32_t totalAllocs() {
+  uint32_t n = 0;
+  for (auto &c : s_counters) n += c.allocs.load();
+  return n;
+}
+
+static uint32_t totalBytes() {
+  uint32_t n = 0;
+  for (auto &c : s_counters) n += c.bytesAllocated.load();
+  return n;
+}
+
+// free bytes, largest free block (0 if unknown)
+static void heapInfo(uint32_t &freeBytes, uint32_t &largestBlock) {
+#ifdef BOARD_SIMULATOR
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 mi = mallinfo2();
+  freeBytes = (uint32_t)mi.fordblks;
+#else
+  freeBytes = 0;
+#endif
+  largestBlock = 0;
+#else
+  freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#endif
+}
+
+void AllocTracker::beginTransition() {
+  s_transitionStart.allocs = totalAllocs();
+  s_transitionStart.bytes = totalBytes();
+  for (int i = 0; i < (int)AllocPhase::Count; i++) {
+    s_transitionStart.live[i] = s_counters[i].liveBytes.load();
+  }
+  s_transitionPeak.store(s_live.load());
+}
+
+void AllocTracker::beginTeardown() {
+  for (int i = 0; i < (int)AllocPhase::Count; i++) {
+    s_teardownStart[i] = s_counters[i].liveBytes.load();
+  }
+}
+
+void AllocTracker::endTeardown() {
+  for (int i = 0; i < (int)AllocPhase::Count; i++) {
+    s_transitionStart.live[i] -=
+        s_teardownStart[i] - s_counters[i].liveBytes.load();
+  }
+}
+
+void AllocTracker::endTransition(int state) {
+  uint32_t freeBytes = 0, largest = 0;
+  heapInfo(freeBytes, largest);
+  Serial.printf("[Alloc] screen %d: %lu allocs, %lu B, peak live %ld B, "
+                "live %ld B (lvgl %ld B)",
+                state, (unsigned long)(totalAllocs() - s_transitionStart.allocs),
+                (unsigned long)(totalBytes() - s_transitionStart.bytes),
+                (long)s_transitionPeak.load(), (long)s_live.load(),
+                (long)s_lvglLive.load());
+  if (largest > 0 && freeBytes > 0) {
+    Serial.printf(", frag %d%%", (int)(100 - (uint64_t)largest * 100 / freeBytes));
+  }
+  Serial.printf("\n");
+
+  // The state at the start of a transition, less the previous screen
+  // (see endTeardown), should be the same every time we arrive at a
+  // given screen.
+  // Anything that grew since the last arrival survived the cycle.
+  ScreenVisit *visit = nullptr;
+  for (int i = 0; i < s_visitCount; i++) {
+    if (s_visits[i].state == state) visit = &s_visits[i];
+  }
+  if (visit != nullptr) {
+    int32_t growth = 0;
+    for (int i = 0; i < (int)AllocPhase::Count; i++) {
+      growth += s_transitionStart.live[i] - visit->live[i];
+    }
+    if (growth > 0) {
+      Serial.printf("[Alloc] screen %d revisit: +%ld B still live since last visit:",
+                    state, (long)growth);
+      for (int i = 0; i < (int)AllocPhase::Count; i++) {
+        int32_t d = s_transitionStart.live[i] - visit->live[i];
+        if (d != 0) Serial.printf(" %s=%+ld", PHASE_NAMES[i], (long)d);
+      }
+      Serial.printf("\n");
+    }
+  } else if (s_visitCount < ALLOC_TRACKER_MAX_SCREENS) {
+    visit = &s_visits[s_visitCount++];
+    visit->state = state;
+  }
+  if (visit != nullptr) {
+    memcpy(visit->live, s_transitionStart.live, sizeof(visit->live));
+  }
+}
+
+void AllocTracker::report() {
+  Serial.printf("[Alloc] %-10s %9s %9s %10s %10s %10s\n", "phase", "allocs",
+                "frees", "bytes", "live", "peak_live");
+  for (int i = 0; i < (int)AllocPhase::Count; i++) {
+    AllocPhaseStats s = stats((AllocPhase)i);
+    Serial.printf("[Alloc] %-10s %9lu %9lu %10lu %10ld %10ld\n", PHASE_NAMES[i],
+                  (unsigned long)s.allocs, (unsigned long)s.frees,
+                  (unsigned long)s.bytesAllocated, (long)s.liveBytes,
+                  (long)s.peakLiveBytes);
+  }
+  uint32_t freeBytes = 0, largest = 0;
+  heapInfo(freeBytes, largest);
+  Serial.printf("[Alloc] live %ld B (lvgl %ld B), heap free %lu B, largest block %lu B\n",
+                (long)s_live.load(), (long)s_lvglLive.load(),
+                (unsigned long)freeBytes, (unsigned long)largest);
+}
+
+#endif // ALLOC_TRACKER
@@ -0,0 +1,90 @@
+#ifndef _ALLOC_TRACKER_H_
+#define _ALLOC_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// What the allocating thread was doing when an allocation was made. Each
+// thread has its own phase, set by AllocScope on that thread; a thread
+// that never sets one allocates as Other.
+enum class AllocPhase : uint8_t {
+  Other,
+  Manifest,       // UserScreenManager::loadManifest
+  ComponentBuild, // JSON → component tree (createComponentFromState)
+  WidgetCreate,   // Component::createWidgets + screen load
+  Network,        // INetwork request/response handling
+  HAString,       // HomeAssistant URL/result Strings
+  Count,
+};
+
+#ifdef ALLOC_TRACKER
+
+struct AllocPhaseStats {
+  uint32_t allocs = 0;
+  uint32_t frees = 0;
+  uint32_t bytesAllocated = 0;
+  int32_t liveBytes = 0;
+  int32_t peakLiveBytes = 0;
+};
+
+// Opt-in heap tracker (-DALLOC_TRACKER). Replaces global operator
+// new/delete and LVGL's allocator (LV_STDLIB_CUSTOM in lv_conf.h) with
+// wrappers that prefix each block with its size and phase. JsonDocuments
+// (util/JsonAllocator.h) and ResponseBuffer blocks come from allocate()
+// too. Plain malloc is only hooked on ESP32 builds linked with
+// -Wl,--wrap=malloc,--wrap=realloc,--wrap=free and
+// -DALLOC_TRACKER_WRAP_MALLOC, which is what counts Arduino String; in the
+// simulator String is std::string-backed and counted anyway.
+//
+// ComponentManager brackets every screen transition, which logs the
+// allocations it made and, when a screen is revisited, any live bytes
+// that grew since its previous visit (i.e. survived a navigate-away /
+// navigate-back cycle), broken down by phase.
+class AllocTracker {
+public:
+  static AllocPhase phase();
+  static void setPhase(AllocPhase phase);
+
+  // Tracked blocks for code with its own allocator hooks
+  static void *allocate(size_t size);
+  static void *reallocate(void *p, size_t size);
+  static void deallocate(void *p);
+
+  static AllocPhaseStats stats(AllocPhase phase);
+  static int32_t liveBytes();
+  static int32_t lvglLiveBytes();
+
+  // Called before the new screen is built / once it is loaded
+  static void beginTransition();
+  static void endTransition(int state);
+  // Bracket deleting the previous screen, which outlives the new one's
+  // build: what it frees comes off the transition's starting point
+  static void beginTeardown();
+  static void endTeardown();
+
+  // Per-phase table plus heap free / largest block / fragmentation
+  static void report();
+};
+
+// Attributes allocations in this scope to a phase.
+class AllocScope {
+private:
+  AllocPhase prev;
+
+public:
+  AllocScope(AllocPhase phase) : prev(AllocTracker::phase()) {
+    AllocTracker::setPhase(phase);
+  }
+  ~AllocScope() { AllocTracker::setPhase(prev); }
+};
+
+#else
+
+class AllocScope {
+public:
+  AllocScope(AllocPhase) {}
+};
+
+#endif // ALLOC_TRACKER
+
+#endif // _ALLOC_TRACKER_H_
@@ -0,0 +1,36 @@
+#ifndef _JSON_ALLOCATOR_H_
+#define _JSON_ALLOCATOR_H_
+
+#include <ArduinoJson.h>
+
+#include "util/AllocTracker.h"
+
+#ifdef ALLOC_TRACKER
+
+// Counts document pools in the allocating thread's AllocPhase
+class TrackedJsonAllocator : public ArduinoJson::Allocator {
+public:
+  void *allocate(size_t size) override { return AllocTracker::allocate(size); }
+  void deallocate(void *p) override { AllocTracker::deallocate(p); }
+  void *reallocate(void *p, size_t size) override {
+    return AllocTracker::reallocate(p, size);
+  }
+
+  static TrackedJsonAllocator *instance() {
+    static TrackedJsonAllocator allocator;
+    return &allocator;
+  }
+};
+
+#endif // ALLOC_TRACKER
+
+// Pass to every JsonDocument: JsonDocument doc(jsonAllocator());
+inline ArduinoJson::Allocator *jsonAllocator() {
+#ifdef ALLOC_TRACKER
+  return TrackedJsonAllocator::instance();
+#else
+  return ArduinoJson::detail::DefaultAllocator::instance();
+#endif
+}
+
+#endif // _JSON_ALLOCATOR_H_
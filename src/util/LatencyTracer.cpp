@@ -0,0 +1,131 @@
+#include <Arduino.h>
+
+#include "util/LatencyTracer.h"
+
+// Traces that never produce a frame (e.g. a tap on empty space) are
+// dropped after this long.
+#define LATENCY_TRACE_TIMEOUT_US 1000000
+
+lv_display_t *LatencyTracer::_disp = nullptr;
+LatencyHistogram LatencyTracer::_histograms[(int)LatencyStage::Count];
+uint16_t LatencyTracer::_nextId = 1;
+uint16_t LatencyTracer::_activeId = 0;
+uint32_t LatencyTracer::_reportUs = 0;
+uint32_t LatencyTracer::_lastMarkUs = 0;
+uint32_t LatencyTracer::_stageUs[(int)LatencyStage::Count] = {};
+uint8_t LatencyTracer::_marked = 0;
+bool LatencyTracer::_logging = false;
+
+static const char *STAGE_NAMES[] = {"gesture", "dispatch", "navigate",
+                                    "rebuild", "photon",   "total"};
+
+static inline uint8_t bit(LatencyStage stage) { return 1 << (int)stage; }
+
+void LatencyTracer::attach(lv_display_t *disp) {
+  _disp = disp;
+  lv_display_add_event_cb(disp, onFlushFinish, LV_EVENT_FLUSH_FINISH, nullptr);
+}
+
+uint16_t LatencyTracer::begin(uint32_t contactUs) {
+  uint32_t now = micros();
+  _activeId = _nextId++;
+  if (_nextId == 0) _nextId = 1; // 0 means "untraced"
+  _reportUs = now;
+  _lastMarkUs = now;
+  _marked = 0;
+  for (auto &us : _stageUs) us = 0;
+  if (contactUs != 0) {
+    _stageUs[(int)LatencyStage::Gesture] = now - contactUs;
+    _marked |= bit(LatencyStage::Gesture);
+    record(LatencyStage::Gesture, now - contactUs);
+  }
+  return _activeId;
+}
+
+void LatencyTracer::mark(uint16_t id, LatencyStage stage) {
+  if (id == 0 || id != _activeId) return;
+  markActive(stage);
+}
+
+void LatencyTracer::markActive(LatencyStage stage) {
+  if (_activeId == 0 || (_marked & bit(stage))) return;
+  // later stages only count once the event has been dispatched
+  if (stage != LatencyStage::Dispatch && !(_marked & bit(LatencyStage::Dispatch))) return;
+  if (stage == LatencyStage::Rebuild && !(_marked & bit(LatencyStage::Navigate))) return;
+
+  uint32_t now = micros();
+  uint32_t us = now - _lastMarkUs;
+  _stageUs[(int)stage] = us;
+  _marked |= bit(stage);
+  _lastMarkUs = now;
+  record(stage, us);
+}
+
+void LatencyTracer::onFlushFinish(lv_event_t *e) {
+  if (_activeId == 0 || !(_marked & bit(LatencyStage::Dispatch))) return;
+
+  uint32_t now = micros();
+  if (now - _reportUs > LATENCY_TRACE_TIMEOUT_US) {
+    _activeId = 0;
+    return;
+  }
+  // a navigation only reaches the panel once the new screen is built
+  if ((_marked & bit(LatencyStage::Navigate)) && !(_marked & bit(LatencyStage::Rebuild))) return;
+  if (!lv_display_flush_is_last(_disp)) return;
+
+  _stageUs[(int)LatencyStage::Photon] = now - _lastMarkUs;
+  _stageUs[(int)LatencyStage::Total] = now - _reportUs;
+  record(LatencyStage::Photon, now - _lastMarkUs);
+  record(LatencyStage::Total, now - _reportUs);
+  _marked |= bit(LatencyStage::Photon) | bit(LatencyStage::Total);
+  finish();
+}
+
+void LatencyTracer::record(LatencyStage stage, uint32_t us) {
+  LatencyHistogram &h = _histograms[(int)stage];
+  h.count++;
+  h.sumUs += us;
+  if (us > h.maxUs) h.maxUs = us;
+  uint32_t ms = us / 1000;
+  int b = 0;
+  while (b < LATENCY_BUCKETS - 1 && ms >= (1u << b)) b++;
+  h.buckets[b]++;
+}
+
+void LatencyTracer::finish() {
+  if (_logging) {
+    Serial.printf("[Latency] #%u", _activeId);
+    for (int i = 0; i < (int)LatencyStage::Count; i++) {
+      if (_marked & (1 << i)) {
+        Serial.printf(" %s=%.1fms", STAGE_NAMES[i], _stageUs[i] / 1000.0f);
+      }
+    }
+    Serial.printf("\n");
+  }
+  _activeId = 0;
+}
+
+const LatencyHistogram &LatencyTracer::histogram(LatencyStage stage) {
+  return _histograms[(int)stage];
+}
+
+void LatencyTracer::dump() {
+  Serial.printf("[Latency] stage     count   mean_ms  max_ms  buckets(<1,<2,<4..<1024,>=1024ms)\n");
+  for (int i = 0; i < (int)LatencyStage::Count; i++) {
+    const LatencyHistogram &h = _histograms[i];
+    Serial.printf("[Latency] %-9s %5lu %9.2f %7.1f ", STAGE_NAMES[i],
+                  (unsigned long)h.count,
+                  h.count ? (float)h.sumUs / 1000.0f / h.count : 0.0f, h.maxUs / 1000.0f);
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+      Serial.printf("%s%lu", b ? "," : "", (unsigned long)h.buckets[b]);
+    }
+    Serial.printf("\n");
+  }
+}
+
+void LatencyTracer::reset() {
+  for (auto &h : _histograms) h = LatencyHistogram();
+  _activeId = 0;
+}
+
+void LatencyTracer::setLogging(bool enabled) { _logging = enabled; }
@@ -0,0 +1,73 @@
+#ifndef _LATENCY_TRACER_H_
+#define _LATENCY_TRACER_H_
+
+#include <stdint.h>
+
+#include "lvgl.h"
+
+// log2 millisecond buckets: <1, <2, <4 ... <1024, >=1024
+#define LATENCY_BUCKETS 12
+
+enum class LatencyStage : uint8_t {
+  Gesture,  // first contact → driver reports the gesture (when known)
+  Dispatch, // driver report → ComponentManager::handleEvent
+  Navigate, // dispatch → Workflow::navigate
+  Rebuild,  // navigate → ComponentManager::createComponent done
+  Photon,   // last mark → last flush of the resulting frame
+  Total,    // driver report → last flush
+  Count,
+};
+
+struct LatencyHistogram {
+  uint32_t count = 0;
+  uint64_t sumUs = 0;
+  uint32_t maxUs = 0;
+  uint32_t buckets[LATENCY_BUCKETS] = {};
+};
+
+// Touch-to-photon tracer. A touch driver opens a trace when it reports a
+// gesture and stores the id on the TouchEvent; later stages are marked as
+// the event moves through dispatch, navigation and rebuild, and the trace
+// closes on the last flush of the next rendered frame. Only one trace is
+// in flight at a time — a new gesture abandons an unfinished one.
+//
+// Usage:
+//   event.traceId = LatencyTracer::begin(contactUs);
+//   LatencyTracer::mark(event.traceId, LatencyStage::Dispatch);
+//   LatencyTracer::markActive(LatencyStage::Navigate);
+//   LatencyTracer::dump();
+//
+class LatencyTracer {
+public:
+  static void attach(lv_display_t *disp);
+
+  // Open a trace at the driver's report time. contactUs is micros() at
+  // first contact, or 0 if the controller only reports finished gestures.
+  static uint16_t begin(uint32_t contactUs = 0);
+  static void mark(uint16_t id, LatencyStage stage);
+  // Mark the in-flight trace, for stages that don't see the event
+  static void markActive(LatencyStage stage);
+
+  static const LatencyHistogram &histogram(LatencyStage stage);
+  static void dump();
+  static void reset();
+  // Print one line per completed trace
+  static void setLogging(bool enabled);
+
+private:
+  static void onFlushFinish(lv_event_t *e);
+  static void record(LatencyStage stage, uint32_t us);
+  static void finish();
+
+  static lv_display_t *_disp;
+  static LatencyHistogram _histograms[(int)LatencyStage::Count];
+  static uint16_t _nextId;
+  static uint16_t _activeId;
+  static uint32_t _reportUs;
+  static uint32_t _lastMarkUs;
+  static uint32_t _stageUs[(int)LatencyStage::Count];
+  static uint8_t _marked; // bitmask of LatencyStage
+  static bool _logging;
+};
+
+#endif // _LATENCY_TRACER_H_
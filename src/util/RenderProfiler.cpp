@@ -0,0 +1,117 @@
+#include <Arduino.h>
+#include <algorithm>
+
+#include "util/RenderProfiler.h"
+
+lv_display_t *RenderProfiler::_disp = nullptr;
+RenderStats RenderProfiler::_current;
+RenderStats RenderProfiler::_last;
+uint32_t RenderProfiler::_samples[RENDER_PROFILER_MAX_SAMPLES];
+uint16_t RenderProfiler::_sampleCount = 0;
+unsigned long RenderProfiler::_windowStart = 0;
+uint32_t RenderProfiler::_loopStart = 0;
+uint32_t RenderProfiler::_stageStart[(int)ProfileStage::Count] = {};
+uint32_t RenderProfiler::_frameFlushes = 0;
+bool RenderProfiler::_logging = false;
+
+static const char *STAGE_NAMES[] = {"touch", "rebuild", "timers", "render", "flush"};
+
+void RenderProfiler::attach(lv_display_t *disp) {
+  _disp = disp;
+  _windowStart = millis();
+  lv_display_add_event_cb(disp, onDisplayEvent, LV_EVENT_INVALIDATE_AREA, nullptr);
+  lv_display_add_event_cb(disp, onDisplayEvent, LV_EVENT_REFR_START, nullptr);
+  lv_display_add_event_cb(disp, onDisplayEvent, LV_EVENT_REFR_READY, nullptr);
+  lv_display_add_event_cb(disp, onDisplayEvent, LV_EVENT_FLUSH_START, nullptr);
+  lv_display_add_event_cb(disp, onDisplayEvent, LV_EVENT_FLUSH_FINISH, nullptr);
+}
+
+void RenderProfiler::onDisplayEvent(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  switch (code) {
+  case LV_EVENT_INVALIDATE_AREA: {
+    auto *area = (const lv_area_t *)lv_event_get_param(e);
+    _current.invalidatedAreas++;
+    if (area) _current.invalidatedPixels += lv_area_get_size(area);
+    break;
+  }
+  case LV_EVENT_REFR_START:
+    _frameFlushes = 0;
+    beginStage(ProfileStage::Render);
+    break;
+  case LV_EVENT_REFR_READY:
+    endStage(ProfileStage::Render);
+    if (_frameFlushes > 0) _current.frames++;
+    break;
+  case LV_EVENT_FLUSH_START:
+    beginStage(ProfileStage::Flush);
+    break;
+  case LV_EVENT_FLUSH_FINISH: {
+    endStage(ProfileStage::Flush);
+    auto *area = (const lv_area_t *)lv_event_get_param(e);
+    if (area) {
+      uint32_t px = lv_area_get_size(area);
+      uint8_t bpp = lv_color_format_get_size(lv_display_get_color_format(_disp));
+      _current.pixelsFlushed += px;
+      _current.bytesFlushed += px * bpp;
+    }
+    _current.flushes++;
+    _frameFlushes++;
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+void RenderProfiler::beginLoop() { _loopStart = micros(); }
+
+void RenderProfiler::endLoop() {
+  uint32_t us = micros() - _loopStart;
+  _current.loops++;
+  if (us > _current.maxUs) _current.maxUs = us;
+  if (_sampleCount < RENDER_PROFILER_MAX_SAMPLES) _samples[_sampleCount++] = us;
+
+  if (millis() - _windowStart >= 1000) rollWindow();
+}
+
+void RenderProfiler::beginStage(ProfileStage stage) {
+  _stageStart[(int)stage] = micros();
+}
+
+void RenderProfiler::endStage(ProfileStage stage) {
+  _current.stageUs[(int)stage] += micros() - _stageStart[(int)stage];
+}
+
+const RenderStats &RenderProfiler::lastSecond() { return _last; }
+
+void RenderProfiler::setLogging(bool enabled) { _logging = enabled; }
+
+void RenderProfiler::rollWindow() {
+  if (_sampleCount > 0) {
+    std::sort(_samples, _samples + _sampleCount);
+    _current.p50Us = _samples[(_sampleCount - 1) * 50 / 100];
+    _current.p95Us = _samples[(_sampleCount - 1) * 95 / 100];
+    _current.p99Us = _samples[(_sampleCount - 1) * 99 / 100];
+  }
+  _last = _current;
+  _current = RenderStats();
+  _sampleCount = 0;
+  _windowStart = millis();
+
+  if (_logging) {
+    Serial.printf("[Render] fps=%u loops=%u p50=%luus p95=%luus p99=%luus max=%luus "
+                  "inv=%lu/%lupx flush=%lu/%lupx %luB\n",
+                  _last.frames, _last.loops, (unsigned long)_last.p50Us,
+                  (unsigned long)_last.p95Us, (unsigned long)_last.p99Us,
+                  (unsigned long)_last.maxUs, (unsigned long)_last.invalidatedAreas,
+                  (unsigned long)_last.invalidatedPixels,
+                  (unsigned long)_last.flushes, (unsigned long)_last.pixelsFlushed,
+                  (unsigned long)_last.bytesFlushed);
+    Serial.printf("[Render] stage us:");
+    for (int i = 0; i < (int)ProfileStage::Count; i++) {
+      Serial.printf(" %s=%lu", STAGE_NAMES[i], (unsigned long)_last.stageUs[i]);
+    }
+    Serial.printf("\n");
+  }
+}
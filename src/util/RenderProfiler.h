@@ -0,0 +1,93 @@
+#ifndef _RENDER_PROFILER_H_
+#define _RENDER_PROFILER_H_
+
+#include <stdint.h>
+
+#include "lvgl.h"
+
+// Upper bound on loop samples kept per one-second window (percentiles are
+// computed over these; loops beyond this still count towards totals).
+#define RENDER_PROFILER_MAX_SAMPLES 256
+
+enum class ProfileStage : uint8_t {
+  Touch,   // ITouch::pollEvent
+  Rebuild, // ComponentManager::createComponent on a state change
+  Timers,  // lv_timer_handler (includes render + flush)
+  Render,  // LVGL refresh, REFR_START..REFR_READY
+  Flush,   // display flush callbacks, FLUSH_START..FLUSH_FINISH
+  Count,
+};
+
+// Aggregates for one completed one-second window.
+struct RenderStats {
+  uint16_t loops = 0;           // Application::loop iterations
+  uint16_t frames = 0;          // refreshes that flushed at least one area
+  uint32_t p50Us = 0;           // loop time percentiles (excluding idle delay)
+  uint32_t p95Us = 0;
+  uint32_t p99Us = 0;
+  uint32_t maxUs = 0;
+  uint32_t stageUs[(int)ProfileStage::Count] = {};
+  uint32_t invalidatedAreas = 0;
+  uint32_t invalidatedPixels = 0;
+  uint32_t flushes = 0;
+  uint32_t pixelsFlushed = 0;
+  uint32_t bytesFlushed = 0;
+};
+
+// Frame profiler for the render pipeline. Stage timings come from the
+// application loop; render, flush and dirty-area counts come from LVGL
+// display events, so every display driver is covered without touching
+// its flushCb.
+//
+// Usage:
+//   RenderProfiler::attach(disp);              // once, after initLVGL()
+//   RenderProfiler::beginLoop();
+//   { ProfileScope s(ProfileStage::Touch); ... }
+//   RenderProfiler::endLoop();
+//   RenderProfiler::lastSecond().p95Us;
+//
+class RenderProfiler {
+public:
+  static void attach(lv_display_t *disp);
+
+  static void beginLoop();
+  static void endLoop();
+
+  static void beginStage(ProfileStage stage);
+  static void endStage(ProfileStage stage);
+
+  // Stats for the most recently completed one-second window.
+  static const RenderStats &lastSecond();
+
+  // Print each completed window to Serial.
+  static void setLogging(bool enabled);
+
+private:
+  static void onDisplayEvent(lv_event_t *e);
+  static void rollWindow();
+
+  static lv_display_t *_disp;
+  static RenderStats _current;
+  static RenderStats _last;
+  static uint32_t _samples[RENDER_PROFILER_MAX_SAMPLES];
+  static uint16_t _sampleCount;
+  static unsigned long _windowStart;
+  static uint32_t _loopStart;
+  static uint32_t _stageStart[(int)ProfileStage::Count];
+  static uint32_t _frameFlushes;
+  static bool _logging;
+};
+
+// Times a stage for the lifetime of the scope.
+class ProfileScope {
+private:
+  ProfileStage stage;
+
+public:
+  ProfileScope(ProfileStage stage) : stage(stage) {
+    RenderProfiler::beginStage(stage);
+  }
+  ~ProfileScope() { RenderProfiler::endStage(stage); }
+};
+
+#endif // _RENDER_PROFILER_H_
@@ -0,0 +1,58 @@
+#ifndef _TOUCH_RECORDER_H_
+#define _TOUCH_RECORDER_H_
+
+#include <Arduino.h>
+#include <stdio.h>
+
+// Records touch input as timestamped lines in the simulator's touch script
+// format (see simulator/platform/TouchScript.h), so a session can be
+// replayed with exact timing:
+//
+//   <ms> down x y / <ms> up x y / <ms> tap x y / <ms> swipe x0 y0 x1 y1
+//
+// Simulator: written to the file given to open().
+// Hardware: printed to Serial with a "[TouchRec] " prefix when the driver is
+// built with -DTOUCH_RECORD; a captured serial log replays as-is.
+class TouchRecorder {
+public:
+#ifdef BOARD_SIMULATOR
+  static bool open(const char *path) {
+    close();
+    file() = fopen(path, "w");
+    return file() != nullptr;
+  }
+
+  static void close() {
+    if (file() != nullptr) fclose(file());
+    file() = nullptr;
+  }
+#endif
+
+  static void down(int x, int y) { write("down %d %d", x, y); }
+  static void up(int x, int y) { write("up %d %d", x, y); }
+  static void tap(int x, int y) { write("tap %d %d", x, y); }
+  static void swipe(int x0, int y0, int x1, int y1) {
+    write("swipe %d %d %d %d", x0, y0, x1, y1);
+  }
+
+private:
+  static FILE *&file() {
+    static FILE *f = nullptr;
+    return f;
+  }
+
+  template <typename... Args>
+  static void write(const char *fmt, Args... args) {
+    char line[64];
+    snprintf(line, sizeof(line), fmt, args...);
+#ifdef BOARD_SIMULATOR
+    if (file() == nullptr) return;
+    fprintf(file(), "%lu %s\n", millis(), line);
+    fflush(file());
+#else
+    Serial.printf("[TouchRec] %lu %s\n", millis(), line);
+#endif
+  }
+};
+
+#endif // _TOUCH_RECORDER_H_
@@ -0,0 +1,75 @@
+#include <Arduino.h>
+
+#include "util/WakeSignal.h"
+
+static unsigned long s_wakeBy = 0;
+static bool s_hasWakeBy = false;
+
+void WakeSignal::wakeBy(unsigned long atMs) {
+  s_wakeBy = atMs;
+  s_hasWakeBy = true;
+}
+
+// Clamp a wait to the wakeBy() deadline, which is consumed
+static uint32_t boundedWait(uint32_t timeoutMs) {
+  if (!s_hasWakeBy) return timeoutMs;
+  s_hasWakeBy = false;
+  unsigned long now = millis();
+  if ((long)(s_wakeBy - now) <= 0) return 0;
+  return s_wakeBy - now < timeoutMs ? (uint32_t)(s_wakeBy - now) : timeoutMs;
+}
+
+#ifndef BOARD_SIMULATOR
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static TaskHandle_t volatile s_loopTask = nullptr;
+
+void WakeSignal::wait(uint32_t timeoutMs) {
+  if (s_loopTask == nullptr) s_loopTask = xTaskGetCurrentTaskHandle();
+  // clear-on-exit, so notifications that piled up count as one wake
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(boundedWait(timeoutMs)));
+}
+
+void WakeSignal::notify() {
+  TaskHandle_t task = s_loopTask;
+  if (task != nullptr) xTaskNotifyGive(task);
+}
+
+void IRAM_ATTR WakeSignal::notifyFromISR() {
+  TaskHandle_t task = s_loopTask;
+  if (task == nullptr) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+#elif defined(SIM_HEADLESS)
+
+// always move the virtual clock, or a zero sleep budget would spin forever
+void WakeSignal::wait(uint32_t timeoutMs) {
+  uint32_t ms = boundedWait(timeoutMs);
+  delay(ms > 0 ? ms : 1);
+}
+void WakeSignal::notify() {}
+void WakeSignal::notifyFromISR() {}
+
+#else
+#include <SDL2/SDL.h>
+
+// Returns as soon as any SDL event is queued (mouse input or a wake from
+// notify()); the simulator main loop pumps the queue before the next
+// Application::loop.
+void WakeSignal::wait(uint32_t timeoutMs) {
+  SDL_WaitEventTimeout(nullptr, (int)boundedWait(timeoutMs));
+}
+
+void WakeSignal::notify() {
+  SDL_Event event = {};
+  event.type = SDL_USEREVENT;
+  SDL_PushEvent(&event);
+}
+
+void WakeSignal::notifyFromISR() { notify(); }
+
+#endif
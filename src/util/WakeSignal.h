@@ -0,0 +1,34 @@
+#ifndef _WAKE_SIGNAL_H_
+#define _WAKE_SIGNAL_H_
+
+#include <stdint.h>
+
+// Lets the UI loop sleep until something actually needs it. The loop calls
+// wait() where it used to delay(); a touch interrupt or a finished
+// background fetch calls notify()/notifyFromISR() to cut the sleep short,
+// so input is handled on arrival rather than on the next fixed tick.
+//
+//   ESP32:          FreeRTOS task notification on the loop task
+//   SDL simulator:  SDL_WaitEventTimeout, notify() pushes an SDL user event
+//   headless:       advances the virtual clock; input is injected between
+//                   iterations, so there is nothing to wake early for
+//
+// Notifications are counted as a single pending wake: several notify()
+// calls before the next wait() make it return once, immediately.
+class WakeSignal {
+public:
+  // Sleep up to timeoutMs, returning early if notified. Must be called
+  // from the loop task (the first call binds it on ESP32).
+  static void wait(uint32_t timeoutMs);
+
+  // Don't let the next wait() sleep past millis() == atMs. For input that
+  // is due at a known time rather than signalled (simulator touch scripts).
+  static void wakeBy(unsigned long atMs);
+
+  // Safe from any task or thread
+  static void notify();
+  // Safe from an interrupt handler (ESP32: place the ISR in IRAM)
+  static void notifyFromISR();
+};
+
+#endif // _WAKE_SIGNAL_H_